@@ -11,83 +11,469 @@
 #include <fstream>
 #include <sstream>
 #include <cstring>
+#include <cstdint>
 #include <algorithm>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
 #include <queue>
+#include <vector>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "scheduler.h"
 
 /* -------------------------- Variable definitaions ------------------------- */
 #define DELIMETER ':'
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+#define WORKLOAD_MAGIC "CPUSCHED" // first 8 bytes of a binary workload file
+#define WORKLOAD_VERSION 2
+#define WORKLOAD_ALIGNMENT 64 // every column starts on a cache line
+#define STREAM_PROGRESS_INTERVAL (1 << 20) // completed jobs between running aggregates
+#define GENERATOR_CHUNK_SIZE (1 << 16)			 // jobs per independently seeded generator chunk
+#define DEFAULT_TICKS_PER_MS 1000						 // default time resolution: 1 tick = 1 microsecond
+#define MAX_TICKS_PER_MS 1000000						 // finest resolution the %f style output can show exactly
+#define DEFAULT_MLFQ_QUANTUMS "8,16,32"							 // feedback queue quantum per level, top level first
+
+Tick ticks_per_ms = DEFAULT_TICKS_PER_MS; // --resolution, a power of ten
+
 int TOTAL_PROCESS = 0;
 bool shoudl_write_to_file = false;
 char *output_file_name = NULL;
+bool echo_to_console = true;
 
 /* ------------------------- Structure definiations ------------------------- */
-struct Process
+
+/**
+ * Header of the binary columnar workload format (native byte order). The
+ * columns follow as plain arrays, each starting on a WORKLOAD_ALIGNMENT
+ * boundary: int32 pid, int64 arrival, int64 burst, int32 priority. Times
+ * are ticks of 1/ticks_per_ms milliseconds. Version 1 files stored float
+ * milliseconds instead and are still read (converted while loading).
+ */
+struct WorkloadFileHeader
 {
-	int pid;
-	float burst_time;
-	float arrival_time;
-	int priority;
-	float remaining_time;
-	float waiting_time;
-	float turnaround_time;
-	float completion_time;
-	float elapsed_time;
-	bool completed;
-	Process *next;
-	Process *prev;
+	char magic[8];					 // WORKLOAD_MAGIC
+	uint32_t version;				 // WORKLOAD_VERSION
+	uint32_t header_size;		 // sizeof(WorkloadFileHeader)
+	uint64_t count;					 // number of processes
+	uint64_t pid_offset;		 // byte offsets of the columns from the start of the file
+	uint64_t arrival_offset;
+	uint64_t burst_offset;
+	uint64_t priority_offset;
+	uint64_t ticks_per_ms;	 // time resolution of the arrival and burst columns
+};
+
+Workload processes; // PROCESSES workload table
+
+struct filenames
+{
+	char *output_file_name;
+	char *input_file_name;
+};
+
+struct batch_options
+{
+	bool enabled;
+	std::vector<std::string> algorithms;
+	std::vector<double> time_quantums;
+	std::vector<double> sweep_quantums; // round robin sweep, see calculateRoundRobinSweep
+	unsigned threads;									 // 0 = one per core
+	bool convert;											 // write the workload to -o in the binary format
+	std::vector<std::string> stream_algorithms; // run straight from the file, see calculateStream
+	Tick ticks_per_ms;													// --resolution, see Tick
+	smp_options smp;														// --cpus, see simulateMultiCore
+	double min_granularity;											// --min-granularity in ms, see simulateFair
+	std::vector<double> mlfq_quantums;						// --mlfq-tq, one level per value, see simulateFeedback
+	double boost_period;													// --boost in ms, 0 = never
 };
 
-Process *head = nullptr; // PROCESSES linked list head
-Process *sortLinkedList(Process *list, std::string method);
-Process *getNextShortestProcess(Process *head, int currentTime, std::vector<int> completedProcesses);
-Process *getNextHighestPriorityProcess(Process *head, int currentTime, std::vector<int> completedProcesses);
+struct output_options
+{
+	bool echo_to_console;
+	bool background_writer;
+	char *metrics_file_name; // NULL = no metrics report
+};
+
+/**
+ * Metrics of a whole program run: global phases plus one entry per simulation
+ */
+struct MetricsReport
+{
+	char *file_name = NULL;
+	double load_seconds = 0;	 // readInputFile
+	double output_seconds = 0; // writeOutput and flushes
+	std::vector<std::pair<std::string, SchedulerMetrics>> runs;
+	std::mutex lock; // simulations finish on worker threads
+};
 
-struct CompareArrivalTimeAndPriority
+/**
+ * Buffered writer for a file descriptor. Text is collected in a large
+ * user-space buffer and written with a single write(2) once the buffer
+ * fills up. With a background writer, full buffers are handed over to a
+ * dedicated thread (double buffering) so the simulation never waits on the
+ * disk unless both buffers are full.
+ */
+struct OutputSink
 {
-	bool operator()(Process const &p1, Process const &p2)
+	int fd = -1;
+	bool background = false;
+	std::string buffer;	 // being filled by the caller
+	std::string pending; // being written by the writer thread
+	bool has_pending = false;
+	bool stopping = false;
+	std::thread writer;
+	std::mutex lock;
+	std::condition_variable changed;
+
+	void open(int descriptor, bool use_background_writer)
 	{
-		if (p1.arrival_time != p2.arrival_time)
+		fd = descriptor;
+		background = use_background_writer;
+		buffer.reserve(OUTPUT_BUFFER_SIZE);
+		if (background)
+			writer = std::thread(&OutputSink::writerLoop, this);
+	}
+
+	bool isOpen() const { return fd != -1; }
+
+	void write(const char *data, size_t length)
+	{
+		if (buffer.size() + length > OUTPUT_BUFFER_SIZE)
+			flushBuffer();
+		buffer.append(data, length);
+	}
+
+	// push everything written so far down to the descriptor
+	void flush()
+	{
+		flushBuffer();
+		std::unique_lock<std::mutex> guard(lock);
+		changed.wait(guard, [this]
+								 { return !has_pending; });
+	}
+
+	void close()
+	{
+		if (fd == -1)
+			return;
+		flush();
+		if (background)
 		{
-			return p1.arrival_time > p2.arrival_time;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				stopping = true;
+			}
+			changed.notify_all();
+			writer.join();
 		}
-		else
+		if (fd > 2)
+			::close(fd);
+		fd = -1;
+	}
+
+private:
+	static void writeAll(int descriptor, const std::string &data)
+	{
+		size_t written = 0;
+		while (written < data.size())
+		{
+			ssize_t count = ::write(descriptor, data.data() + written, data.size() - written);
+			if (count <= 0)
+				return;
+			written += count;
+		}
+	}
+
+	void flushBuffer()
+	{
+		if (buffer.empty())
+			return;
+		if (!background)
 		{
-			return p1.priority > p2.priority;
+			writeAll(fd, buffer);
+			buffer.clear();
+			return;
+		}
+
+		std::unique_lock<std::mutex> guard(lock);
+		changed.wait(guard, [this]
+								 { return !has_pending; });
+		pending.swap(buffer);
+		has_pending = true;
+		guard.unlock();
+		changed.notify_all();
+	}
+
+	void writerLoop()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (true)
+		{
+			changed.wait(guard, [this]
+									 { return has_pending || stopping; });
+			if (!has_pending)
+				return;
+
+			guard.unlock();
+			writeAll(fd, pending);
+			pending.clear();
+			guard.lock();
+
+			has_pending = false;
+			changed.notify_all();
 		}
 	}
 };
 
-// Comparison function to sort the queue by remaining time
-struct CompareRemainingTime
+OutputSink console_sink; // standard output
+OutputSink file_sink;		 // output_file_name, opened on first write
+MetricsReport metrics_report;
+
+// A process read by the streaming mode; it only lives while it is in the system
+struct StreamJob
+{
+	int pid;
+	Tick arrival_time;
+	Tick burst_time;
+	int priority;
+	Tick remaining_time;
+	Tick response_time; // -1 until first dispatched
+};
+
+// Streaming SJF order: shortest burst first, then arrival, priority and pid
+struct CompareStreamShortestBurst
 {
-	bool operator()(Process const &p1, Process const &p2)
+	const std::vector<StreamJob> *jobs;
+
+	// "less" for std heaps: true when slot j1 should run after slot j2
+	bool operator()(int j1, int j2) const
 	{
-		return p1.remaining_time > p2.remaining_time;
+		const StreamJob &p1 = (*jobs)[j1], &p2 = (*jobs)[j2];
+		if (p1.burst_time != p2.burst_time)
+			return p1.burst_time > p2.burst_time;
+		if (p1.arrival_time != p2.arrival_time)
+			return p1.arrival_time > p2.arrival_time;
+		if (p1.priority != p2.priority)
+			return p1.priority < p2.priority;
+		return p1.pid > p2.pid;
 	}
 };
 
-struct filenames
+// Streaming priority order: highest priority first, then arrival and pid
+struct CompareStreamPriority
 {
+	const std::vector<StreamJob> *jobs;
+
+	bool operator()(int j1, int j2) const
+	{
+		const StreamJob &p1 = (*jobs)[j1], &p2 = (*jobs)[j2];
+		if (p1.priority != p2.priority)
+			return p1.priority < p2.priority;
+		if (p1.arrival_time != p2.arrival_time)
+			return p1.arrival_time > p2.arrival_time;
+		return p1.pid > p2.pid;
+	}
+};
+
+// Streaming ready queue in arrival order (FCFS and round robin)
+struct StreamFifo
+{
+	RingBuffer queue;
+
+	StreamFifo(const std::vector<StreamJob> &) : queue(64) {}
+
+	bool empty() const { return queue.empty(); }
+	size_t size() const { return queue.size(); }
+	void push(int slot) { queue.push(slot); }
+	int pop() { return queue.pop(); }
+};
+
+// Streaming ready queue ordered by Compare (SJF and priority)
+template <class Compare>
+struct StreamHeap
+{
+	Compare compare;
+	std::vector<int> heap;
+
+	StreamHeap(const std::vector<StreamJob> &jobs) : compare{&jobs} {}
+
+	bool empty() const { return heap.empty(); }
+	size_t size() const { return heap.size(); }
+
+	void push(int slot)
+	{
+		heap.push_back(slot);
+		std::push_heap(heap.begin(), heap.end(), compare);
+	}
+
+	int pop()
+	{
+		std::pop_heap(heap.begin(), heap.end(), compare);
+		int slot = heap.back();
+		heap.pop_back();
+		return slot;
+	}
+};
+
+/**
+ * Reads "burst:arrival:priority" records from a text workload one at a time
+ * through a fixed-size buffer, so traces larger than memory can be
+ * simulated. Records must be in arrival order.
+ */
+struct RecordStream
+{
+	int fd;
+	std::string file_name;
+	std::vector<char> buffer;
+	size_t begin, end; // unread bytes in buffer
+	bool eof;
+	size_t line_number;
+	int next_pid;
+	Tick last_arrival;
+
+	RecordStream(std::string input_file_name);
+	~RecordStream();
+	bool next(StreamJob &job);
+
+private:
+	bool fill();
+};
+
+enum ArrivalProcess
+{
+	ARRIVAL_POISSON, // exponential gaps between single arrivals
+	ARRIVAL_BURSTY	 // groups of jobs arriving at the same instant, exponential gaps between groups
+};
+
+enum BurstDistribution
+{
+	BURST_EXPONENTIAL, // mean
+	BURST_PARETO,			 // shape alpha, minimum
+	BURST_BIMODAL			 // short mean, long mean, probability of long
+};
+
+enum PriorityMix
+{
+	PRIORITY_UNIFORM, // every value in [low, high] equally likely
+	PRIORITY_WEIGHTED // value i drawn with weight i
+};
+
+// Settings of the synthetic workload generator (--generate)
+struct generator_options
+{
+	long long count; // processes to generate, 0 = generator not requested
 	char *output_file_name;
-	char *input_file_name;
+	uint64_t seed;
+	ArrivalProcess arrival;
+	double arrival_rate; // jobs per millisecond
+	int group_size;			 // ARRIVAL_BURSTY only
+	BurstDistribution burst;
+	double burst_parameters[3];
+	PriorityMix priority;
+	int priority_low, priority_high;
+	std::vector<double> priority_weights;
+};
+
+/**
+ * xoshiro256** pseudo random generator. Every generator chunk gets its own
+ * stream derived from (seed, chunk, stream), so a workload only depends on
+ * the seed and never on the number of threads.
+ */
+struct Random
+{
+	uint64_t state[4];
+
+	Random(uint64_t seed, uint64_t chunk, uint64_t stream)
+	{
+		uint64_t x = seed ^ (chunk * 0x9E3779B97F4A7C15ULL) ^ (stream << 56);
+		for (uint64_t &word : state)
+		{
+			// splitmix64
+			uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	uint64_t next()
+	{
+		uint64_t result = rotate(state[1] * 5, 7) * 9;
+		uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotate(state[3], 45);
+		return result;
+	}
+
+	// uniform in [0, 1)
+	double uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+	double exponential(double mean) { return -mean * std::log1p(-uniform()); }
+
+private:
+	static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
 };
 
 filenames getCommandLineArguments(int argc, char *argv[]);
+batch_options getBatchArguments(int argc, char *argv[]);
+generator_options getGeneratorArguments(int argc, char *argv[]);
+output_options getOutputArguments(int argc, char *argv[]);
+std::vector<double> parseQuantumList(std::string value, std::string option);
+// Produces one algorithm's report into a buffer owned by the caller
+typedef std::function<void(std::string &report)> ReportTask;
+
+void openOutput(output_options options);
+void runReports(const std::vector<ReportTask> &tasks, unsigned thread_count);
+void writeOutput(const std::string &report);
+Tick ticksFromMilliseconds(double milliseconds);
+double averageMilliseconds(TickTotal total, long long count);
+int formatTicks(char *buffer, size_t size, Tick value, bool fixed);
+void flushOutput();
+void closeOutput();
+void writeMetricsReport(const MetricsReport &metrics);
+void exitWithError(std::string message);
 
 /* ------------------------- function defininations ------------------------- */
 void readInputFile(std::string input_file_name);
+void mapBinaryWorkload(Workload &table, const char *data, size_t size, std::string file_name);
+void loadTimeColumn(Column<Tick> &column, const char *data, size_t count, uint64_t resolution);
+void writeBinaryWorkload(const Workload &table, std::string file_name);
+void writeTextWorkload(const Workload &table, std::string file_name, unsigned thread_count);
+void generateWorkload(Workload &table, const generator_options &generator, unsigned thread_count);
 
-int displayMenu(bool premtive, int type, float TQ);
+int displayMenu(bool premtive, int type, double TQ);
 int displaySchedulingMenu();
 
-void createProcess(Process **head, int pid, float arrival_time, float burst_time, int priority);
-
-void calculateFCFS();
-void calculateSJFNonPremptive();
-void calculateSJFPremptive();
-void calculatePriorityNonPreemptive();
-void calculatePriorityPreemptive();
-void calculateRoundRobin(float TQ);
+void createProcess(Workload &table, int pid, Tick arrival_time, Tick burst_time, int priority);
+
+void calculateFCFS(std::string &report);
+void calculateSJFNonPremptive(std::string &report);
+void calculateSJFPremptive(std::string &report);
+void calculatePriorityNonPreemptive(std::string &report);
+void calculatePriorityPreemptive(std::string &report);
+void calculateRoundRobin(std::string &report, double TQ);
+void calculateRoundRobinSweep(std::string &report, const std::vector<double> &quantums, unsigned thread_count);
+void calculateMultiCore(std::string &report, std::string algorithm, double TQ, smp_options smp);
+void calculateFair(std::string &report, double min_granularity);
+void calculateFeedback(std::string &report, const std::vector<double> &quantums, double boost_period);
+void writeSummary(std::string &report, const ResultSummary &summary);
+void runBatch(batch_options batch);
+void runAlgorithms(batch_options batch);
+void calculateStream(std::string algorithm, double TQ, std::string input_file_name);
+#ifdef BENCHMARK
+int runBenchmarks(int argc, char *argv[]);
+#endif
 
 /**
  * @brief Main entry point
@@ -99,17 +485,71 @@ void calculateRoundRobin(float TQ);
  */
 int main(int argc, char *argv[])
 {
-	system("clear");
+#ifdef BENCHMARK
+	return runBenchmarks(argc, argv);
+#endif
 
 	/* -------------- get command line arguments and store results -------------- */
+	batch_options batch = getBatchArguments(argc, argv);
+	ticks_per_ms = batch.ticks_per_ms;
+
+	/* ------------ generator mode: write a synthetic workload and leave ---------- */
+	generator_options generator = getGeneratorArguments(argc, argv);
+	if (generator.count > 0)
+	{
+		std::string destination = generator.output_file_name;
+		generateWorkload(processes, generator, batch.threads);
+		if (destination.size() > 4 && destination.compare(destination.size() - 4, 4, ".bin") == 0)
+			writeBinaryWorkload(processes, destination);
+		else
+			writeTextWorkload(processes, destination, batch.threads);
+		exit(EXIT_SUCCESS);
+	}
+
 	filenames files = getCommandLineArguments(argc, argv);
 	output_file_name = files.output_file_name;
+	openOutput(getOutputArguments(argc, argv));
+
+	/* ------------- streaming mode: never load the whole workload -------------- */
+	if (!batch.stream_algorithms.empty())
+	{
+		shoudl_write_to_file = true;
+		for (std::string algorithm : batch.stream_algorithms)
+			if (algorithm != "rr")
+				calculateStream(algorithm, 0.0, files.input_file_name);
+			else
+				for (double time_quantum : batch.time_quantums)
+					calculateStream(algorithm, time_quantum, files.input_file_name);
+		closeOutput();
+		exit(EXIT_SUCCESS);
+	}
 
 	/* ------------------ read input file and create processes ------------------ */
-	readInputFile(files.input_file_name);
+	{
+		METRIC_PHASE(load_timer, metrics_report.load_seconds);
+		readInputFile(files.input_file_name);
+	}
+
+	/* ------------- convert mode: store the workload in binary format ------------ */
+	if (batch.convert)
+	{
+		writeBinaryWorkload(processes, files.output_file_name);
+		closeOutput();
+		exit(EXIT_SUCCESS);
+	}
+
+	/* ------------- headless mode: run requested methods and leave ------------- */
+	if (batch.enabled)
+	{
+		runBatch(batch);
+		closeOutput();
+		exit(EXIT_SUCCESS);
+	}
+
+	system("clear");
 
 	int option, type;
-	float time_quantum = 0.0f;
+	double time_quantum = 0.0;
 	bool isPreemptive = false;
 
 	/* -------------------------- display menu options -------------------------- */
@@ -130,7 +570,7 @@ int main(int argc, char *argv[])
 					std::cin >> time_quantum;
 				}
 				system("clear");
-			} while (type != 1 && type != 2 && type != 3 && type != 4);
+			} while (type != 1 && type != 2 && type != 3 && type != 4 && type != 5);
 			break;
 
 		case 2: // Boolean for setting method to preemptive or non-preemptive
@@ -139,32 +579,40 @@ int main(int argc, char *argv[])
 			break;
 
 		case 3: // case for displaying results
+		{
+			std::string report;
 			switch (type)
 			{
 			case 1: // case fo displaying first come first serve algorithm
 				system("clear");
-				calculateFCFS();
+				calculateFCFS(report);
 				break;
 			case 2: // case for displaying shortest job first algorithm
 				system("clear");
 				if (!isPreemptive)
-					calculateSJFNonPremptive();
+					calculateSJFNonPremptive(report);
 				else
-					calculateSJFPremptive();
+					calculateSJFPremptive(report);
 				break;
 			case 3: // case for displaying priority scheduling algorithm
 				system("clear");
 				if (!isPreemptive)
-					calculatePriorityNonPreemptive();
+					calculatePriorityNonPreemptive(report);
 				else
-					calculatePriorityPreemptive();
+					calculatePriorityPreemptive(report);
 				break;
 			case 4: // case for displaying round robin scheduling algorithm
 				system("clear");
-				calculateRoundRobin(time_quantum);
+				calculateRoundRobin(report, time_quantum);
+				break;
+			case 5: // case for displaying the completely fair scheduler
+				system("clear");
+				calculateFair(report, DEFAULT_MIN_GRANULARITY_MS);
 				break;
 			}
+			writeOutput(report);
 			break;
+		}
 		case 4:
 			if (time_quantum == 0)
 			{
@@ -173,17 +621,24 @@ int main(int argc, char *argv[])
 			}
 			shoudl_write_to_file = true;
 			system("clear");
-			calculateFCFS();
-			calculateSJFNonPremptive();
-			// calculateSJFPremptive();
-			calculatePriorityNonPreemptive();
-			calculateRoundRobin(time_quantum);
+			// every method runs on its own thread, reports are written in this order
+			runReports({calculateFCFS,
+									calculateSJFNonPremptive,
+									calculateSJFPremptive,
+									calculatePriorityNonPreemptive,
+									[time_quantum](std::string &report)
+									{ calculateRoundRobin(report, time_quantum); },
+									[](std::string &report)
+									{ calculateFair(report, DEFAULT_MIN_GRANULARITY_MS); }},
+								 0);
 			break;
 		default:
 			break;
 		}
+		flushOutput();
 	} while (option != 4);
 
+	closeOutput();
 	exit(EXIT_SUCCESS);
 }
 
@@ -198,46 +653,27 @@ int main(int argc, char *argv[])
 filenames getCommandLineArguments(int argc, char *argv[])
 {
 
-	char *input_file_name, *output_file_name;
+	char *input_file_name = NULL, *output_file_name = NULL;
 
-	// Check if both -f and -o arguments are present
-	bool f_present = false;
-	bool o_present = false;
-	for (int i = 1; i < argc; i++)
+	for (int i = 1; i + 1 < argc; i++)
 	{
 		if (strcmp(argv[i], "-f") == 0)
-			f_present = true;
-		if (strcmp(argv[i], "-o") == 0)
-			o_present = true;
+			input_file_name = argv[++i];
+		else if (strcmp(argv[i], "-o") == 0)
+			output_file_name = argv[++i];
 	}
-	if (!f_present || !o_present)
+
+	// Check if both -f and -o arguments are present
+	if (input_file_name == NULL || output_file_name == NULL)
 	{
 		std::cout << "Error: Please specify both -f and -o arguments." << std::endl;
 		exit(1);
 	}
 
-	for (int i = 1; i < argc; i++)
-		if (i + 1 != argc)
-		{
-			if (strcmp(argv[i], "-f") == 0)
-				input_file_name = argv[i + 1];
-			if (strcmp(argv[i], "-o") == 0)
-				output_file_name = argv[i + 1];
-			i++;
-		}
-
 	// Validate input file name
 	FILE *input_file = fopen(input_file_name, "r");
 	if (input_file == NULL)
-	{
-		system("clear");
-		std::cout << " -------------------------------------------------------------------------- " << std::endl;
-		std::cerr << " ERROR: "
-							<< "\"" << input_file_name << "\""
-							<< " doesn't exists or is un-reachable" << std::endl;
-		std::cout << " -------------------------------------------------------------------------- " << std::endl;
-		exit(1);
-	}
+		exitWithError("\"" + std::string(input_file_name) + "\" doesn't exists or is un-reachable");
 	fclose(input_file);
 
 	std::ifstream output_file(output_file_name);
@@ -250,78 +686,1279 @@ filenames getCommandLineArguments(int argc, char *argv[])
 	}
 	else
 	{
-		// Output file does not exist, create it
-		std::ofstream create_output_file(output_file_name);
-		create_output_file.close();
+		// Output file does not exist, create it
+		std::ofstream create_output_file(output_file_name);
+		create_output_file.close();
+	}
+	output_file.close();
+
+	return filenames{output_file_name, input_file_name};
+}
+
+/**
+ * @brief split a comma separated command line value ("fcfs,sjf,rr")
+ *
+ * @param value raw argument value
+ *
+ * @return std::vector<std::string> list of non-empty items
+ */
+std::vector<std::string> splitArgumentList(std::string value)
+{
+	std::vector<std::string> items;
+	std::stringstream ss(value);
+	std::string item;
+	while (std::getline(ss, item, ','))
+		if (!item.empty())
+			items.push_back(item);
+	return items;
+}
+
+/**
+ * @brief parse quantum values for a sweep: a list ("2,4,8") or a range ("1:100:0.5" = start:end:step)
+ *
+ * @param value raw argument value
+ *
+ * @return std::vector<double> quantum values in the given order
+ */
+std::vector<double> parseQuantumSweep(std::string value)
+{
+	std::vector<double> quantums;
+
+	if (value.find(':') != std::string::npos)
+	{
+		double start, end, step;
+		char trailing;
+		if (sscanf(value.c_str(), "%lf:%lf:%lf%c", &start, &end, &step, &trailing) != 3 || start <= 0 || end < start || step <= 0)
+			exitWithError("invalid quantum range \"" + value + "\" (expected start:end:step)");
+		// count the steps in integers so rounding can't drop the last value
+		long long steps = (long long)((end - start) / step + 1e-9);
+		for (long long k = 0; k <= steps; k++)
+			quantums.push_back(start + k * step);
+		return quantums;
+	}
+
+	return parseQuantumList(value, "--sweep-tq");
+}
+
+/**
+ * @brief parse a comma separated list of quantum values ("2,4,8")
+ *
+ * @param value raw argument value
+ * @param option option name, used in error messages
+ *
+ * @return std::vector<double> quantum values in the given order
+ */
+std::vector<double> parseQuantumList(std::string value, std::string option)
+{
+	std::vector<double> quantums;
+	for (std::string quantum : splitArgumentList(value))
+	{
+		char *end = NULL;
+		double time_quantum = strtod(quantum.c_str(), &end);
+		if (*end != '\0' || time_quantum <= 0)
+			exitWithError("invalid quantum time value \"" + quantum + "\"");
+		quantums.push_back(time_quantum);
+	}
+	if (quantums.empty())
+		exitWithError(option + " needs at least one quantum value");
+	return quantums;
+}
+
+/**
+ * @brief get headless (batch) mode arguments: --algo <list>, --tq <list>, --sweep-tq <list|range>, --stream <list>, --threads <n>,
+ * --resolution <ticks per ms>, --min-granularity <ms>, --mlfq-tq <list>, --boost <ms> and the multi-core options --cpus <n>, --queue <per-core|global> and --no-steal
+ *
+ * @param argc Argument count (contains the number of arguments)
+ * @param argv Argument vector (contains argument's values)
+ *
+ * @return batch_options structure, enabled when any headless mode is requested
+ */
+batch_options getBatchArguments(int argc, char *argv[])
+{
+	batch_options batch{false, {}, {}, {}, 0, false, {}, DEFAULT_TICKS_PER_MS, {0, false, true}, DEFAULT_MIN_GRANULARITY_MS, {}, 0};
+	bool has_round_robin = false, has_core_options = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--convert") == 0)
+			batch.enabled = batch.convert = true;
+		else if (strcmp(argv[i], "--no-steal") == 0)
+		{
+			batch.smp.steal = false;
+			has_core_options = true;
+		}
+	}
+
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--algo") == 0)
+		{
+			batch.enabled = true;
+			for (std::string algorithm : splitArgumentList(argv[++i]))
+			{
+				if (algorithm != "fcfs" && algorithm != "sjf" && algorithm != "srtf" &&
+						algorithm != "prio" && algorithm != "prio-p" && algorithm != "rr" && algorithm != "cfs" && algorithm != "mlfq")
+					exitWithError("unknown scheduling method \"" + algorithm + "\" (expected fcfs, sjf, srtf, prio, prio-p, rr, cfs or mlfq)");
+				has_round_robin = has_round_robin || algorithm == "rr";
+				batch.algorithms.push_back(algorithm);
+			}
+		}
+		else if (strcmp(argv[i], "--stream") == 0)
+		{
+			batch.enabled = true;
+			for (std::string algorithm : splitArgumentList(argv[++i]))
+			{
+				if (algorithm != "fcfs" && algorithm != "sjf" && algorithm != "prio" && algorithm != "rr")
+					exitWithError("unknown streaming method \"" + algorithm + "\" (expected fcfs, sjf, prio or rr)");
+				has_round_robin = has_round_robin || algorithm == "rr";
+				batch.stream_algorithms.push_back(algorithm);
+			}
+		}
+		else if (strcmp(argv[i], "--sweep-tq") == 0)
+		{
+			batch.enabled = true;
+			batch.sweep_quantums = parseQuantumSweep(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0)
+		{
+			char *end = NULL;
+			long threads = strtol(argv[++i], &end, 10);
+			if (*end != '\0' || threads < 0)
+				exitWithError("invalid thread count \"" + std::string(argv[i]) + "\"");
+			batch.threads = threads;
+		}
+		else if (strcmp(argv[i], "--resolution") == 0)
+		{
+			char *end = NULL;
+			long long resolution = strtoll(argv[++i], &end, 10);
+			if (*end != '\0' || resolution < 1 || resolution > MAX_TICKS_PER_MS || MAX_TICKS_PER_MS % resolution != 0)
+				exitWithError("invalid resolution \"" + std::string(argv[i]) + "\" (expected ticks per ms: 1, 10, 100, ... or " + std::to_string(MAX_TICKS_PER_MS) + ")");
+			batch.ticks_per_ms = resolution;
+		}
+		else if (strcmp(argv[i], "--min-granularity") == 0)
+		{
+			char *end = NULL;
+			batch.min_granularity = strtod(argv[++i], &end);
+			if (*end != '\0' || batch.min_granularity <= 0)
+				exitWithError("invalid minimum granularity \"" + std::string(argv[i]) + "\"");
+		}
+		else if (strcmp(argv[i], "--cpus") == 0)
+		{
+			char *end = NULL;
+			long cpus = strtol(argv[++i], &end, 10);
+			if (*end != '\0' || cpus < 1 || cpus > MAX_CPUS)
+				exitWithError("invalid CPU count \"" + std::string(argv[i]) + "\" (expected 1 to " + std::to_string(MAX_CPUS) + ")");
+			batch.smp.cpus = cpus;
+		}
+		else if (strcmp(argv[i], "--queue") == 0)
+		{
+			std::string queue = argv[++i];
+			if (queue != "per-core" && queue != "global")
+				exitWithError("unknown run queue layout \"" + queue + "\" (expected per-core or global)");
+			batch.smp.global_queue = queue == "global";
+			has_core_options = true;
+		}
+		else if (strcmp(argv[i], "--tq") == 0)
+		{
+			std::vector<double> quantums = parseQuantumList(argv[++i], "--tq");
+			batch.time_quantums.insert(batch.time_quantums.end(), quantums.begin(), quantums.end());
+		}
+		else if (strcmp(argv[i], "--mlfq-tq") == 0)
+		{
+			batch.mlfq_quantums = parseQuantumList(argv[++i], "--mlfq-tq");
+			if (batch.mlfq_quantums.size() > MLFQ_MAX_LEVELS)
+				exitWithError("--mlfq-tq takes at most " + std::to_string(MLFQ_MAX_LEVELS) + " levels");
+		}
+		else if (strcmp(argv[i], "--boost") == 0)
+		{
+			char *end = NULL;
+			batch.boost_period = strtod(argv[++i], &end);
+			if (*end != '\0' || batch.boost_period < 0)
+				exitWithError("invalid boost period \"" + std::string(argv[i]) + "\" (0 turns boosting off)");
+		}
+	}
+	if (batch.mlfq_quantums.empty())
+		batch.mlfq_quantums = parseQuantumList(DEFAULT_MLFQ_QUANTUMS, "--mlfq-tq");
+
+	if (batch.algorithms.empty() && batch.stream_algorithms.empty() && !batch.time_quantums.empty())
+		exitWithError("--tq can only be used together with --algo or --stream");
+	if (!batch.stream_algorithms.empty() && (!batch.algorithms.empty() || !batch.sweep_quantums.empty() || batch.convert))
+		exitWithError("--stream can't be combined with --algo, --sweep-tq or --convert");
+	if (has_round_robin && batch.time_quantums.empty())
+		exitWithError("round robin (rr) requires at least one --tq value");
+	if (has_core_options && batch.smp.cpus == 0)
+		exitWithError("--queue and --no-steal can only be used together with --cpus");
+	if (batch.smp.cpus > 0)
+	{
+		if (batch.algorithms.empty() || !batch.stream_algorithms.empty() || !batch.sweep_quantums.empty())
+			exitWithError("--cpus can only be used together with --algo");
+		for (std::string algorithm : batch.algorithms)
+			if (algorithm == "srtf" || algorithm == "prio-p" || algorithm == "cfs" || algorithm == "mlfq")
+				exitWithError("\"" + algorithm + "\" has no multi-core version (expected fcfs, sjf, prio or rr with --cpus)");
+	}
+
+	// A quantum must last at least one tick
+	for (const std::vector<double> *quantums : {&batch.time_quantums, &batch.sweep_quantums, &batch.mlfq_quantums})
+		for (double quantum : *quantums)
+			if (std::llround(quantum * batch.ticks_per_ms) < 1)
+				exitWithError("quantum " + std::to_string(quantum) + " is shorter than one tick, use a finer --resolution");
+	if (std::llround(batch.min_granularity * batch.ticks_per_ms) < 1)
+		exitWithError("minimum granularity " + std::to_string(batch.min_granularity) + " is shorter than one tick, use a finer --resolution");
+	if (batch.boost_period > 0 && std::llround(batch.boost_period * batch.ticks_per_ms) < 1)
+		exitWithError("boost period " + std::to_string(batch.boost_period) + " is shorter than one tick, use a finer --resolution");
+
+	return batch;
+}
+
+/**
+ * @brief parse the comma separated numbers after "name:" in a generator setting
+ *
+ * @param option option name, used in error messages
+ * @param value raw value such as "pareto:1.5,2"
+ * @param name expected distribution name
+ * @param count number of parameters expected, 0 for any non-zero amount
+ * @param parameters parsed numbers
+ *
+ * @return bool false when value is not of the form name[:...]
+ */
+bool parseDistribution(std::string option, std::string value, std::string name, size_t count, std::vector<double> &parameters)
+{
+	if (value.compare(0, name.size(), name) != 0 || (value.size() > name.size() && value[name.size()] != ':'))
+		return false;
+
+	parameters.clear();
+	for (std::string item : splitArgumentList(value.size() > name.size() ? value.substr(name.size() + 1) : ""))
+	{
+		char *end = NULL;
+		parameters.push_back(strtod(item.c_str(), &end));
+		if (*end != '\0')
+			exitWithError("invalid number \"" + item + "\" in " + option + " " + value);
+	}
+	if ((count > 0 && parameters.size() != count) || (count == 0 && parameters.empty()))
+		exitWithError(option + " " + name + " expects " + (count ? std::to_string(count) : std::string("at least one")) + " parameter(s)");
+	return true;
+}
+
+/**
+ * @brief get generator arguments: --generate <n> -o <file> [--arrival ..] [--burst ..] [--priority ..] [--seed s]
+ *
+ * @param argc Argument count (contains the number of arguments)
+ * @param argv Argument vector (contains argument's values)
+ *
+ * @return generator_options structure, count is 0 when --generate is absent
+ */
+generator_options getGeneratorArguments(int argc, char *argv[])
+{
+	generator_options generator{0, NULL, 1, ARRIVAL_POISSON, 0.2, 1, BURST_EXPONENTIAL, {4.0, 0, 0}, PRIORITY_UNIFORM, 0, 9, {}};
+	std::vector<double> parameters;
+
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--generate")
+		{
+			char *end = NULL;
+			generator.count = strtoll(argv[++i], &end, 10);
+			if (*end != '\0' || generator.count <= 0 || generator.count > INT32_MAX)
+				exitWithError("invalid process count \"" + std::string(argv[i]) + "\"");
+		}
+		else if (option == "-o")
+			generator.output_file_name = argv[++i];
+		else if (option == "--seed")
+			generator.seed = strtoull(argv[++i], NULL, 10);
+		else if (option == "--arrival")
+		{
+			std::string value = argv[++i];
+			if (parseDistribution(option, value, "poisson", 1, parameters))
+				generator.arrival = ARRIVAL_POISSON;
+			else if (parseDistribution(option, value, "bursty", 2, parameters))
+			{
+				generator.arrival = ARRIVAL_BURSTY;
+				generator.group_size = parameters[1];
+			}
+			else
+				exitWithError("unknown arrival process \"" + value + "\" (expected poisson:<rate> or bursty:<rate>,<group size>)");
+			generator.arrival_rate = parameters[0];
+			if (generator.arrival_rate <= 0 || generator.group_size < 1)
+				exitWithError("arrival rate and group size must be positive");
+		}
+		else if (option == "--burst")
+		{
+			std::string value = argv[++i];
+			if (parseDistribution(option, value, "exp", 1, parameters))
+				generator.burst = BURST_EXPONENTIAL;
+			else if (parseDistribution(option, value, "pareto", 2, parameters))
+				generator.burst = BURST_PARETO;
+			else if (parseDistribution(option, value, "bimodal", 3, parameters))
+				generator.burst = BURST_BIMODAL;
+			else
+				exitWithError("unknown burst distribution \"" + value + "\" (expected exp:<mean>, pareto:<alpha>,<min> or bimodal:<short>,<long>,<p long>)");
+			for (size_t k = 0; k < parameters.size(); k++)
+			{
+				if (parameters[k] <= 0)
+					exitWithError("burst distribution parameters must be positive");
+				generator.burst_parameters[k] = parameters[k];
+			}
+		}
+		else if (option == "--priority")
+		{
+			std::string value = argv[++i];
+			if (parseDistribution(option, value, "uniform", 2, parameters))
+			{
+				generator.priority = PRIORITY_UNIFORM;
+				generator.priority_low = parameters[0];
+				generator.priority_high = parameters[1];
+				if (generator.priority_low > generator.priority_high)
+					exitWithError("--priority uniform needs low <= high");
+			}
+			else if (parseDistribution(option, value, "mix", 0, parameters))
+			{
+				generator.priority = PRIORITY_WEIGHTED;
+				generator.priority_weights = parameters;
+			}
+			else
+				exitWithError("unknown priority mix \"" + value + "\" (expected uniform:<low>,<high> or mix:<w0>,<w1>,...)");
+		}
+	}
+
+	if (generator.count > 0 && generator.output_file_name == NULL)
+		exitWithError("--generate needs an output file (-o)");
+	return generator;
+}
+
+/**
+ * @brief print an error message and terminate the program
+ *
+ * @param message error description
+ */
+void exitWithError(std::string message)
+{
+	flushOutput();
+	std::cout << " -------------------------------------------------------------------------- " << std::endl;
+	std::cerr << " ERROR: " << message << std::endl;
+	std::cout << " -------------------------------------------------------------------------- " << std::endl;
+	exit(1);
+}
+
+/**
+ * @brief get output arguments: --no-echo, --async-output and --metrics <file>
+ *
+ * @param argc Argument count (contains the number of arguments)
+ * @param argv Argument vector (contains argument's values)
+ *
+ * @return output_options structure
+ */
+output_options getOutputArguments(int argc, char *argv[])
+{
+	output_options options{true, false, NULL};
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--no-echo") == 0)
+			options.echo_to_console = false;
+		else if (strcmp(argv[i], "--async-output") == 0)
+			options.background_writer = true;
+		else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc)
+			options.metrics_file_name = argv[++i];
+	}
+	return options;
+}
+
+/**
+ * @brief set up the console sink; the file sink is opened on its first write
+ *
+ * @param options console echo, background writer and metrics report switches
+ */
+void openOutput(output_options options)
+{
+	echo_to_console = options.echo_to_console;
+	console_sink.open(STDOUT_FILENO, false);
+	file_sink.background = options.background_writer;
+
+#ifdef NO_METRICS
+	if (options.metrics_file_name != NULL)
+		exitWithError("--metrics is not available, the program was built with NO_METRICS");
+#endif
+	metrics_report.file_name = options.metrics_file_name;
+}
+
+/**
+ * @brief write buffered console and file output (before prompting the user)
+ */
+void flushOutput()
+{
+	METRIC_PHASE(output_timer, metrics_report.output_seconds);
+	std::cout.flush();
+	console_sink.flush();
+	if (file_sink.isOpen())
+		file_sink.flush();
+}
+
+/**
+ * @brief flush and close every output sink, then write the metrics report if requested
+ */
+void closeOutput()
+{
+	{
+		METRIC_PHASE(output_timer, metrics_report.output_seconds);
+		std::cout.flush();
+		console_sink.close();
+		file_sink.close();
+	}
+	if (metrics_report.file_name != NULL)
+		writeMetricsReport(metrics_report);
+}
+
+/**
+ * @brief store phase times and per-run counters, as JSON when the file name ends in ".json" and as a text table otherwise
+ *
+ * @param metrics collected metrics of the program run
+ */
+void writeMetricsReport(const MetricsReport &metrics)
+{
+	std::string file_name = metrics.file_name;
+	bool json = file_name.size() > 5 && file_name.compare(file_name.size() - 5, 5, ".json") == 0;
+	std::string text;
+	char line[512];
+
+	if (json)
+	{
+		snprintf(line, sizeof(line), "{\n  \"load_seconds\": %.9f,\n  \"output_seconds\": %.9f,\n  \"runs\": [\n",
+						 metrics.load_seconds, metrics.output_seconds);
+		text += line;
+	}
+	else
+	{
+		snprintf(line, sizeof(line), " Load: %.6fs  Output: %.6fs\n %-20s %10s %10s %10s %10s %11s %11s %11s %11s %14s %8s %10s\n",
+						 metrics.load_seconds, metrics.output_seconds, "Run", "Sort [s]", "Sim [s]", "Report [s]", "Agg [s]", "Dispatches",
+						 "Preemptions", "Switches", "Queue ops", "Idle [ms]", "CPU %", "Peak ready");
+		text += line;
+	}
+
+	for (size_t i = 0; i < metrics.runs.size(); i++)
+	{
+		const std::string &name = metrics.runs[i].first;
+		const SchedulerMetrics &run = metrics.runs[i].second;
+		double utilization = run.makespan > 0 ? (double)(run.makespan - run.idle_time) / run.makespan : 0.0;
+		double idle_time = (double)run.idle_time / ticks_per_ms, makespan = (double)run.makespan / ticks_per_ms;
+		if (json)
+			snprintf(line, sizeof(line),
+							 "    {\"name\": \"%s\", \"sort_seconds\": %.9f, \"simulate_seconds\": %.9f, \"report_seconds\": %.9f, \"aggregate_seconds\": %.9f, "
+							 "\"dispatches\": %lld, \"preemptions\": %lld, \"context_switches\": %lld, \"queue_operations\": %lld, "
+							 "\"idle_time\": %.3f, \"makespan\": %.3f, \"utilization\": %.6f, \"peak_ready\": %zu}%s\n",
+							 name.c_str(), run.sort_seconds, run.simulate_seconds, run.report_seconds, run.aggregate_seconds, run.dispatches,
+							 run.preemptions, run.context_switches, run.queue_operations, idle_time, makespan, utilization, run.peak_ready,
+							 i + 1 < metrics.runs.size() ? "," : "");
+		else
+			snprintf(line, sizeof(line), " %-20s %10.6f %10.6f %10.6f %10.6f %11lld %11lld %11lld %11lld %14.1f %8.2f %10zu\n",
+							 name.c_str(), run.sort_seconds, run.simulate_seconds, run.report_seconds, run.aggregate_seconds, run.dispatches,
+							 run.preemptions, run.context_switches, run.queue_operations, idle_time, utilization * 100, run.peak_ready);
+		text += line;
+	}
+	if (json)
+		text += "  ]\n}\n";
+
+	std::ofstream file(file_name, std::ofstream::trunc);
+	if (!file)
+		exitWithError("unable to open \"" + file_name + "\" for writing");
+	file << text;
+}
+
+/**
+ * @brief echo a finished report to the console and, once enabled, append it to the output file
+ *
+ * @param report text made of complete lines
+ */
+void writeOutput(const std::string &report)
+{
+	METRIC_PHASE(output_timer, metrics_report.output_seconds);
+	if (echo_to_console)
+		console_sink.write(report.data(), report.size());
+
+	if (shoudl_write_to_file)
+	{
+		if (!file_sink.isOpen())
+		{
+			int fd = open(output_file_name, O_WRONLY | O_CREAT | O_APPEND, 0644);
+			if (fd == -1)
+				exitWithError("unable to open \"" + std::string(output_file_name) + "\" for writing");
+			file_sink.open(fd, file_sink.background);
+		}
+		file_sink.write(report.data(), report.size());
+	}
+}
+
+/**
+ * @brief append a line to a report
+ *
+ * @param report buffer owned by the run producing it
+ * @param content text without the trailing newline
+ */
+void writeToReport(std::string &report, const std::string &content)
+{
+	report += content;
+	report += '\n';
+}
+
+/**
+ * @brief append a " P<pid>: <waiting time>" result line without building strings
+ *
+ * @param report buffer owned by the run producing it
+ * @param pid process number
+ * @param waiting_time waiting time of the process
+ */
+void writeProcessLine(std::string &report, int pid, Tick waiting_time)
+{
+	char line[64];
+	int length = snprintf(line, sizeof(line), " P%d: ", pid);
+	length += formatTicks(line + length, sizeof(line) - length, waiting_time, true);
+	line[length++] = '\n';
+	report.append(line, length);
+}
+
+/**
+ * @brief run independent reports concurrently, then output them in order
+ *
+ * The workload is shared read-only; every task writes into its own report
+ * and keeps its own simulation state, so no locking is needed. Reports are
+ * written in task order regardless of which one finished first.
+ *
+ * @param tasks reports to produce
+ * @param thread_count number of worker threads (0 = one per core)
+ */
+void runReports(const std::vector<ReportTask> &tasks, unsigned thread_count)
+{
+	std::vector<std::string> reports(tasks.size());
+	runParallel(tasks.size(), thread_count, [&](size_t task)
+							{ tasks[task](reports[task]); });
+
+	for (const std::string &report : reports)
+		writeOutput(report);
+}
+
+/**
+ * @brief scan an unsigned decimal number of milliseconds ("12", "3.5") as ticks
+ *
+ * The digits are converted exactly; digits finer than one tick round the
+ * value to the nearest tick (half up).
+ *
+ * @param cursor position to read from, moved past the number on success
+ * @param end end of the current record
+ * @param value parsed value in ticks
+ *
+ * @return bool false when the field does not start with a digit or doesn't fit in a Tick
+ */
+bool scanTicks(const char *&cursor, const char *end, Tick &value)
+{
+	const char *p = cursor;
+	Tick whole = 0;
+
+	if (p == end || *p < '0' || *p > '9')
+		return false;
+	while (p != end && *p >= '0' && *p <= '9')
+	{
+		if (whole > (INT64_MAX - 9) / 10)
+			return false;
+		whole = whole * 10 + (*p++ - '0');
+	}
+	if (whole > INT64_MAX / ticks_per_ms)
+		return false;
+
+	// At most ticks_per_ms: the digits stay below one millisecond, rounding adds one tick
+	Tick fraction = 0;
+	if (p != end && *p == '.')
+	{
+		p++;
+		Tick scale = ticks_per_ms;
+		bool rounded = false;
+		for (; p != end && *p >= '0' && *p <= '9'; p++)
+		{
+			if (scale >= 10)
+			{
+				scale /= 10;
+				fraction += (*p - '0') * scale;
+			}
+			else if (!rounded)
+			{
+				fraction += *p >= '5';
+				rounded = true;
+			}
+		}
+	}
+	if (whole * ticks_per_ms > INT64_MAX - fraction)
+		return false;
+	value = whole * ticks_per_ms + fraction;
+
+	cursor = p;
+	return true;
+}
+
+/**
+ * @brief scan a signed decimal integer ("3", "-2") from the mapped bytes
+ *
+ * @param cursor position to read from, moved past the number on success
+ * @param end end of the current record
+ * @param value parsed value
+ *
+ * @return bool false when the field is not an integer
+ */
+bool scanInteger(const char *&cursor, const char *end, int &value)
+{
+	const char *p = cursor;
+	bool negative = p != end && *p == '-';
+	long long integer = 0;
+
+	if (negative)
+		p++;
+	if (p == end || *p < '0' || *p > '9')
+		return false;
+	while (p != end && *p >= '0' && *p <= '9' && integer <= INT32_MAX)
+		integer = integer * 10 + (*p++ - '0');
+	if (integer > INT32_MAX)
+		return false;
+
+	value = negative ? -integer : integer;
+	cursor = p;
+	return true;
+}
+
+/**
+ * @brief parse one "burst:arrival:priority" record
+ *
+ * @param cursor start of the record
+ * @param end end of the record (newline excluded)
+ * @param burst_time parsed burst time
+ * @param arrival_time parsed arrival time
+ * @param priority parsed priority
+ *
+ * @return bool false when the record is malformed
+ */
+bool parseRecord(const char *cursor, const char *end, Tick &burst_time, Tick &arrival_time, int &priority)
+{
+	if (!scanTicks(cursor, end, burst_time) || cursor == end || *cursor++ != DELIMETER)
+		return false;
+	if (!scanTicks(cursor, end, arrival_time) || cursor == end || *cursor++ != DELIMETER)
+		return false;
+	if (!scanInteger(cursor, end, priority))
+		return false;
+
+	return cursor == end;
+}
+
+/**
+ * @brief convert milliseconds (command line values, generated times) to the nearest tick
+ *
+ * @param milliseconds time in milliseconds
+ *
+ * @return Tick time in ticks
+ */
+Tick ticksFromMilliseconds(double milliseconds)
+{
+	return std::llround(milliseconds * ticks_per_ms);
+}
+
+/**
+ * @brief average of an exact tick total, in milliseconds
+ *
+ * @param total sum over the workload
+ * @param count number of processes
+ *
+ * @return double average in milliseconds, 0 for an empty workload
+ */
+double averageMilliseconds(TickTotal total, long long count)
+{
+	if (count == 0)
+		return 0.0;
+	return (double)total / count / ticks_per_ms;
+}
+
+/**
+ * @brief print a tick value as exact decimal milliseconds
+ *
+ * @param buffer destination
+ * @param size size of buffer
+ * @param value time in ticks
+ * @param fixed six decimals like "%f" when true, trailing zeros dropped otherwise
+ *
+ * @return int number of characters written
+ */
+int formatTicks(char *buffer, size_t size, Tick value, bool fixed)
+{
+	const char *sign = value < 0 ? "-" : "";
+	unsigned long long magnitude = value < 0 ? -(unsigned long long)value : value;
+	unsigned long long whole = magnitude / ticks_per_ms;
+	unsigned long long fraction = magnitude % ticks_per_ms * (MAX_TICKS_PER_MS / ticks_per_ms);
+
+	if (fixed)
+		return snprintf(buffer, size, "%s%llu.%06llu", sign, whole, fraction);
+	if (fraction == 0)
+		return snprintf(buffer, size, "%s%llu", sign, whole);
+	int digits = 6;
+	for (; fraction % 10 == 0; digits--)
+		fraction /= 10;
+	return snprintf(buffer, size, "%s%llu.%0*llu", sign, whole, digits, fraction);
+}
+
+/**
+ * @brief open a text workload for streaming
+ *
+ * @param input_file_name text workload, records in arrival order
+ */
+RecordStream::RecordStream(std::string input_file_name)
+		: file_name(input_file_name), buffer(OUTPUT_BUFFER_SIZE), begin(0), end(0), eof(false), line_number(0), next_pid(0), last_arrival(0)
+{
+	fd = open(input_file_name.c_str(), O_RDONLY);
+	if (fd == -1)
+		exitWithError("\"" + input_file_name + "\" doesn't exists or is un-reachable");
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+RecordStream::~RecordStream()
+{
+	close(fd);
+}
+
+/**
+ * @brief read more bytes after the unread ones, growing the buffer for very long lines
+ *
+ * @return bool false at end of file
+ */
+bool RecordStream::fill()
+{
+	if (eof)
+		return false;
+
+	memmove(buffer.data(), buffer.data() + begin, end - begin);
+	end -= begin;
+	begin = 0;
+	if (end == buffer.size())
+		buffer.resize(buffer.size() * 2);
+
+	ssize_t count = read(fd, buffer.data() + end, buffer.size() - end);
+	if (count <= 0)
+	{
+		eof = true;
+		return false;
+	}
+	end += count;
+	return true;
+}
+
+/**
+ * @brief read the next record, skipping blank lines
+ *
+ * @param job filled with the record, pid is its position in the file
+ *
+ * @return bool false once the file is exhausted
+ */
+bool RecordStream::next(StreamJob &job)
+{
+	while (true)
+	{
+		const char *line = buffer.data() + begin;
+		const char *line_end = (const char *)memchr(line, '\n', end - begin);
+		if (line_end == NULL && fill())
+			continue;
+		if (line_end == NULL && begin == end)
+			return false;
+
+		// The last line may have no newline
+		line = buffer.data() + begin;
+		if (line_end == NULL)
+		{
+			line_end = buffer.data() + end;
+			begin = end;
+		}
+		else
+			begin = line_end - buffer.data() + 1;
+		line_number++;
+
+		const char *first = line, *last = line_end;
+		while (first < last && isspace((unsigned char)*first))
+			first++;
+		while (last > first && isspace((unsigned char)last[-1]))
+			last--;
+		if (first == last)
+			continue;
+
+		if (!parseRecord(first, last, job.burst_time, job.arrival_time, job.priority))
+			exitWithError("\"" + file_name + "\" line " + std::to_string(line_number) +
+										": malformed record \"" + std::string(first, last) + "\" (expected burst:arrival:priority)");
+		if (job.arrival_time < last_arrival)
+			exitWithError("\"" + file_name + "\" line " + std::to_string(line_number) +
+										": streaming needs records in arrival order");
+
+		last_arrival = job.arrival_time;
+		job.pid = ++next_pid;
+		job.remaining_time = job.burst_time;
+		job.response_time = -1;
+		return true;
+	}
+}
+
+/**
+*	@brief read input file into the workload table
+*
+*	The file is memory-mapped. A binary workload (see WorkloadFileHeader) is
+*	used in place; otherwise every "burst:arrival:priority" record is parsed
+*	straight from the mapped bytes. Blank lines are skipped and a malformed
+*	record stops the program with its line number.
+*
+*	@param input_file_name
+
+*	@return void
+*/
+void readInputFile(std::string input_file_name)
+{
+	/* ---------------------- map the input file into memory --------------------- */
+	int fd = open(input_file_name.c_str(), O_RDONLY);
+	struct stat file_stat;
+	if (fd == -1 || fstat(fd, &file_stat) == -1)
+		exitWithError("\"" + input_file_name + "\" doesn't exists or is un-reachable");
+
+	size_t size = file_stat.st_size;
+	if (size == 0)
+	{
+		close(fd);
+		TOTAL_PROCESS = 0;
+		return;
+	}
+
+	const char *data = (const char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		exitWithError("unable to map \"" + input_file_name + "\" into memory");
+
+	// Binary workloads are used in place, the mapping stays alive for the whole run
+	if (size >= sizeof(WorkloadFileHeader) && memcmp(data, WORKLOAD_MAGIC, 8) == 0)
+	{
+		mapBinaryWorkload(processes, data, size, input_file_name);
+		TOTAL_PROCESS = processes.size();
+		return;
+	}
+
+	madvise((void *)data, size, MADV_SEQUENTIAL);
+	madvise((void *)data, size, MADV_WILLNEED);
+
+	const char *end = data + size;
+
+	// Count records up front so every column is allocated exactly once
+	size_t lines = 1;
+	for (const char *p = data; (p = (const char *)memchr(p, '\n', end - p)) != NULL; p++)
+		lines++;
+	processes.pid.reserve(lines);
+	processes.arrival_time.reserve(lines);
+	processes.burst_time.reserve(lines);
+	processes.priority.reserve(lines);
+
+	int number_of_process = 0; // Current Process number while inside the loop
+	size_t line_number = 0;
+	const char *line = data;
+
+	while (line < end)
+	{
+		const char *line_end = (const char *)memchr(line, '\n', end - line);
+		if (line_end == NULL)
+			line_end = end;
+		line_number++;
+
+		// Trim surrounding whitespace (and the '\r' of CRLF files)
+		const char *first = line, *last = line_end;
+		while (first < last && isspace((unsigned char)*first))
+			first++;
+		while (last > first && isspace((unsigned char)last[-1]))
+			last--;
+
+		if (first != last)
+		{
+			Tick burst_time, arrival_time;
+			int priority;
+			if (!parseRecord(first, last, burst_time, arrival_time, priority))
+			{
+				std::string record(first, last);
+				munmap((void *)data, size);
+				exitWithError("\"" + input_file_name + "\" line " + std::to_string(line_number) +
+											": malformed record \"" + record + "\" (expected burst:arrival:priority)");
+			}
+			number_of_process++;
+
+			createProcess(
+					processes,				 // workload table
+					number_of_process, // Current process number
+					arrival_time,			 // Arrival time of current process
+					burst_time,				 // Burst time of current process
+					priority					 // Priority of current process
+			);
+		}
+
+		line = line_end + 1;
+	}
+
+	munmap((void *)data, size);
+	TOTAL_PROCESS = number_of_process;
+}
+
+/**
+ * @brief use a memory-mapped binary workload as the process table, without parsing
+ *
+ * @param table workload table, its columns become views into data
+ * @param data mapped file, must stay mapped while the table is in use
+ * @param size size of the mapping in bytes
+ * @param file_name used in error messages
+ *
+ * @return void
+ */
+void mapBinaryWorkload(Workload &table, const char *data, size_t size, std::string file_name)
+{
+	WorkloadFileHeader header;
+	memcpy(&header, data, sizeof(header));
+
+	if ((header.version != 1 && header.version != WORKLOAD_VERSION) || header.header_size != sizeof(WorkloadFileHeader))
+		exitWithError("\"" + file_name + "\" is binary workload version " + std::to_string(header.version) +
+									", expected version 1 or " + std::to_string(WORKLOAD_VERSION));
+
+	// Version 1 stored float milliseconds, version 2 stores ticks at a power of ten resolution
+	uint64_t resolution = header.version == 1 ? 0 : header.ticks_per_ms;
+	if (header.version != 1 && (resolution == 0 || resolution > MAX_TICKS_PER_MS || MAX_TICKS_PER_MS % resolution != 0))
+		exitWithError("\"" + file_name + "\" has an unsupported time resolution");
+	size_t time_size = header.version == 1 ? sizeof(float) : sizeof(Tick);
+
+	// Every column must be aligned and lie completely inside the file
+	uint64_t offsets[] = {header.pid_offset, header.arrival_offset, header.burst_offset, header.priority_offset};
+	size_t sizes[] = {sizeof(int), time_size, time_size, sizeof(int)};
+	for (int column = 0; column < 4; column++)
+		if (offsets[column] % WORKLOAD_ALIGNMENT != 0 || offsets[column] > size || header.count > (size - offsets[column]) / sizes[column])
+			exitWithError("\"" + file_name + "\" is a truncated or corrupt binary workload");
+
+	table.pid.view((const int *)(data + header.pid_offset), header.count);
+	table.priority.view((const int *)(data + header.priority_offset), header.count);
+	if (resolution == (uint64_t)ticks_per_ms)
+	{
+		table.arrival_time.view((const Tick *)(data + header.arrival_offset), header.count);
+		table.burst_time.view((const Tick *)(data + header.burst_offset), header.count);
+		return;
+	}
+
+	// Older files and other resolutions are converted into owned columns
+	loadTimeColumn(table.arrival_time, data + header.arrival_offset, header.count, resolution);
+	loadTimeColumn(table.burst_time, data + header.burst_offset, header.count, resolution);
+}
+
+/**
+ * @brief copy a binary workload time column into ticks of the current resolution
+ *
+ * @param column destination column, replaced
+ * @param data first value of the column in the file
+ * @param count number of values
+ * @param resolution ticks per millisecond of the file, 0 for version 1 float milliseconds
+ *
+ * @return void
+ */
+void loadTimeColumn(Column<Tick> &column, const char *data, size_t count, uint64_t resolution)
+{
+	column.clear();
+	column.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (resolution == 0)
+			column.push_back(ticksFromMilliseconds(((const float *)data)[i]));
+		else if (resolution < (uint64_t)ticks_per_ms)
+			column.push_back(((const Tick *)data)[i] * (ticks_per_ms / resolution));
+		else
+		{
+			// Coarser target: round to the nearest tick
+			Tick step = resolution / ticks_per_ms;
+			column.push_back((((const Tick *)data)[i] + step / 2) / step);
+		}
+	}
+}
+
+/**
+ * @brief append one column to a binary workload, padded to the next aligned offset
+ *
+ * @param file output stream
+ * @param values column values
+ * @param bytes size of the column in bytes
+ *
+ * @return uint64_t offset the column was written at
+ */
+uint64_t writeBinaryColumn(std::ofstream &file, const void *values, size_t bytes)
+{
+	static const char padding[WORKLOAD_ALIGNMENT] = {};
+	uint64_t offset = file.tellp();
+	if (offset % WORKLOAD_ALIGNMENT != 0)
+	{
+		file.write(padding, WORKLOAD_ALIGNMENT - offset % WORKLOAD_ALIGNMENT);
+		offset = file.tellp();
+	}
+	file.write((const char *)values, bytes);
+	return offset;
+}
+
+/**
+ * @brief store the workload in the binary columnar format (see WorkloadFileHeader)
+ *
+ * @param table workload table
+ * @param file_name destination file, overwritten
+ *
+ * @return void
+ */
+void writeBinaryWorkload(const Workload &table, std::string file_name)
+{
+	std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		exitWithError("unable to open \"" + file_name + "\" for writing");
+
+	WorkloadFileHeader header{};
+	memcpy(header.magic, WORKLOAD_MAGIC, 8);
+	header.version = WORKLOAD_VERSION;
+	header.header_size = sizeof(WorkloadFileHeader);
+	header.count = table.size();
+	header.ticks_per_ms = ticks_per_ms;
+	file.write((const char *)&header, sizeof(header));
+
+	header.pid_offset = writeBinaryColumn(file, table.pid.begin(), table.size() * sizeof(int));
+	header.arrival_offset = writeBinaryColumn(file, table.arrival_time.begin(), table.size() * sizeof(Tick));
+	header.burst_offset = writeBinaryColumn(file, table.burst_time.begin(), table.size() * sizeof(Tick));
+	header.priority_offset = writeBinaryColumn(file, table.priority.begin(), table.size() * sizeof(int));
+
+	// Offsets are only known now, rewrite the header
+	file.seekp(0);
+	file.write((const char *)&header, sizeof(header));
+	if (!file.good())
+		exitWithError("failed writing \"" + file_name + "\"");
+}
+
+/**
+ * @brief draw one burst time, rounded to whole milliseconds (at least 1)
+ *
+ * @param generator distribution settings
+ * @param random chunk random stream
+ *
+ * @return Tick burst time
+ */
+Tick generateBurst(const generator_options &generator, Random &random)
+{
+	const double *parameter = generator.burst_parameters;
+	double burst = 0;
+	switch (generator.burst)
+	{
+	case BURST_EXPONENTIAL:
+		burst = random.exponential(parameter[0]);
+		break;
+	case BURST_PARETO:
+		burst = parameter[1] / std::pow(1.0 - random.uniform(), 1.0 / parameter[0]);
+		break;
+	case BURST_BIMODAL:
+		burst = random.exponential(random.uniform() < parameter[2] ? parameter[1] : parameter[0]);
+		break;
+	}
+	return ticksFromMilliseconds(std::max(1.0, std::round(std::min(burst, 1e9))));
+}
+
+/**
+ * @brief draw the gap between process index and the one before it
+ *
+ * @param generator arrival settings
+ * @param random chunk arrival stream
+ * @param index global process index
+ *
+ * @return double gap in milliseconds
+ */
+double generateArrivalGap(const generator_options &generator, Random &random, long long index)
+{
+	if (generator.arrival == ARRIVAL_BURSTY && index % generator.group_size != 0)
+		return 0.0;
+	return random.exponential(generator.group_size / generator.arrival_rate);
+}
+
+/**
+ * @brief fill the process table with a seeded synthetic workload, in parallel
+ *
+ * The workload is cut into chunks of GENERATOR_CHUNK_SIZE processes, each
+ * with its own random streams. Arrival times are a running sum, so chunks
+ * first add up their gaps, then replay the same stream on top of the sum of
+ * the chunks before them. Times are rounded to whole milliseconds.
+ *
+ * @param table workload table, replaced
+ * @param generator distributions, size and seed
+ * @param thread_count number of worker threads (0 = one per core)
+ *
+ * @return void
+ */
+void generateWorkload(Workload &table, const generator_options &generator, unsigned thread_count)
+{
+	size_t count = generator.count;
+	size_t chunks = (count + GENERATOR_CHUNK_SIZE - 1) / GENERATOR_CHUNK_SIZE;
+
+	table.pid.resize(count);
+	table.arrival_time.resize(count);
+	table.burst_time.resize(count);
+	table.priority.resize(count);
+
+	std::vector<double> cumulative_weights;
+	for (double weight : generator.priority_weights)
+		cumulative_weights.push_back(weight + (cumulative_weights.empty() ? 0.0 : cumulative_weights.back()));
+
+	// Pass 1: total arrival gap of every chunk
+	std::vector<double> chunk_start(chunks + 1, 0.0);
+	runParallel(chunks, thread_count, [&](size_t chunk)
+							{
+		Random arrivals(generator.seed, chunk, 0);
+		size_t first = chunk * GENERATOR_CHUNK_SIZE, last = std::min(count, first + GENERATOR_CHUNK_SIZE);
+		double total = 0.0;
+		for (size_t i = first; i < last; i++)
+			total += generateArrivalGap(generator, arrivals, i);
+		chunk_start[chunk + 1] = total; });
+
+	for (size_t chunk = 0; chunk < chunks; chunk++)
+		chunk_start[chunk + 1] += chunk_start[chunk];
+
+	// Pass 2: every column, arrivals continue from the chunk's start
+	runParallel(chunks, thread_count, [&](size_t chunk)
+							{
+		Random arrivals(generator.seed, chunk, 0), values(generator.seed, chunk, 1);
+		size_t first = chunk * GENERATOR_CHUNK_SIZE, last = std::min(count, first + GENERATOR_CHUNK_SIZE);
+		double arrival_time = chunk_start[chunk];
+		for (size_t i = first; i < last; i++)
+		{
+			arrival_time += generateArrivalGap(generator, arrivals, i);
+			table.pid.storage[i] = i + 1;
+			table.arrival_time.storage[i] = ticksFromMilliseconds(std::round(arrival_time));
+			table.burst_time.storage[i] = generateBurst(generator, values);
+
+			if (generator.priority == PRIORITY_UNIFORM)
+				table.priority.storage[i] = generator.priority_low + (int)(values.uniform() * (generator.priority_high - generator.priority_low + 1.0));
+			else
+			{
+				double pick = values.uniform() * cumulative_weights.back();
+				table.priority.storage[i] = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), pick) - cumulative_weights.begin();
+				table.priority.storage[i] = std::min<int>(table.priority.storage[i], cumulative_weights.size() - 1);
+			}
+		} });
+
+	TOTAL_PROCESS = count;
+}
+
+/**
+ * @brief store the workload as "burst:arrival:priority" text, formatted in parallel
+ *
+ * @param table workload table
+ * @param file_name destination file, overwritten
+ * @param thread_count number of worker threads (0 = one per core)
+ *
+ * @return void
+ */
+void writeTextWorkload(const Workload &table, std::string file_name, unsigned thread_count)
+{
+	int fd = open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1)
+		exitWithError("unable to open \"" + file_name + "\" for writing");
+	OutputSink sink;
+	sink.open(fd, true);
+
+	// Format a batch of chunks concurrently, then write them in order
+	size_t chunks = (table.size() + GENERATOR_CHUNK_SIZE - 1) / GENERATOR_CHUNK_SIZE;
+	size_t batch = std::max(1u, thread_count ? thread_count : std::thread::hardware_concurrency()) * 4;
+	std::vector<std::string> text(batch);
+	for (size_t base = 0; base < chunks; base += batch)
+	{
+		size_t in_batch = std::min(batch, chunks - base);
+		runParallel(in_batch, thread_count, [&](size_t k)
+								{
+			size_t first = (base + k) * GENERATOR_CHUNK_SIZE, last = std::min(table.size(), first + GENERATOR_CHUNK_SIZE);
+			text[k].clear();
+			char line[96];
+			for (size_t i = first; i < last; i++)
+			{
+				int length = formatTicks(line, sizeof(line), table.burst_time[i], false);
+				line[length++] = DELIMETER;
+				length += formatTicks(line + length, sizeof(line) - length, table.arrival_time[i], false);
+				length += snprintf(line + length, sizeof(line) - length, "%c%d\n", DELIMETER, table.priority[i]);
+				text[k].append(line, length);
+			} });
+		for (size_t k = 0; k < in_batch; k++)
+			sink.write(text[k].data(), text[k].size());
 	}
-	output_file.close();
-
-	return filenames{output_file_name, input_file_name};
+	sink.close();
 }
 
-void writeToFile(std::string content)
+/**
+ * @brief run the requested scheduling methods without the interactive menu
+ *
+ * @param batch methods, round robin quantum values, quantum sweep and thread count
+ *
+ * @return void
+ */
+void runBatch(batch_options batch)
 {
+	shoudl_write_to_file = true;
 
-	std::cout << content << std::endl;
+	if (!batch.algorithms.empty())
+		runAlgorithms(batch);
 
-	if (shoudl_write_to_file)
+	if (!batch.sweep_quantums.empty())
 	{
-		std::ofstream output_file;
-		output_file.open(output_file_name, std::ios::out | std::ios::app);
-		output_file << content << std::endl;
-		output_file.close();
+		std::string report;
+		calculateRoundRobinSweep(report, batch.sweep_quantums, batch.threads);
+		writeOutput(report);
 	}
 }
 
 /**
-*	@brief read input file and return a structure
-*
-*	@param input_file_name
-
-*	@return void
-*/
-void readInputFile(std::string input_file_name)
+ * @brief run the methods listed in --algo concurrently, reports follow the given order
+ *
+ * @param batch methods, round robin quantum values and thread count
+ *
+ * @return void
+ */
+void runAlgorithms(batch_options batch)
 {
-	/* ------------------ input/output file stream declarations ----------------- */
-	std::ifstream inFile(input_file_name, std::ios::in);
-	int number_of_process = 0; // Current Process number while inside the loop
-
-	if (inFile.is_open())
+	std::vector<ReportTask> tasks;
+	for (std::string algorithm : batch.algorithms)
 	{
-		std::string line;
-
-		while (std::getline(inFile, line))
-		{
-			std::stringstream ss(line);
-			std::string burst_time, arrival_time, priority;
-			std::getline(ss, burst_time, DELIMETER);
-			std::getline(ss, arrival_time, DELIMETER);
-			std::getline(ss, priority, DELIMETER);
-			number_of_process++;
-
-			createProcess(
-					&head,							// linked list head
-					number_of_process,	// Current process number
-					stof(arrival_time), // Arrival time of current process | casting string to float
-					stof(burst_time),		// Burst time of current process | casting string to float
-					stoi(priority)			// Priority of current process | casting string to integer
-			);
-		}
-		inFile.close();
-		TOTAL_PROCESS = number_of_process;
+		smp_options smp = batch.smp;
+		if (smp.cpus > 0 && algorithm != "rr")
+			tasks.push_back([algorithm, smp](std::string &report)
+											{ calculateMultiCore(report, algorithm, 0.0, smp); });
+		else if (smp.cpus > 0)
+			for (double time_quantum : batch.time_quantums)
+				tasks.push_back([time_quantum, smp](std::string &report)
+												{ calculateMultiCore(report, "rr", time_quantum, smp); });
+		else if (algorithm == "fcfs")
+			tasks.push_back(calculateFCFS);
+		else if (algorithm == "sjf")
+			tasks.push_back(calculateSJFNonPremptive);
+		else if (algorithm == "srtf")
+			tasks.push_back(calculateSJFPremptive);
+		else if (algorithm == "prio")
+			tasks.push_back(calculatePriorityNonPreemptive);
+		else if (algorithm == "prio-p")
+			tasks.push_back(calculatePriorityPreemptive);
+		else if (algorithm == "rr")
+			for (double time_quantum : batch.time_quantums)
+				tasks.push_back([time_quantum](std::string &report)
+												{ calculateRoundRobin(report, time_quantum); });
+		else if (algorithm == "cfs")
+			tasks.push_back([min_granularity = batch.min_granularity](std::string &report)
+											{ calculateFair(report, min_granularity); });
+		else if (algorithm == "mlfq")
+			tasks.push_back([quantums = batch.mlfq_quantums, boost_period = batch.boost_period](std::string &report)
+											{ calculateFeedback(report, quantums, boost_period); });
 	}
+
+	runReports(tasks, batch.threads);
 }
 
 /**
  *	@brief display menu on cli for user input selection
  *
  *	@param premtive boolean to check if preemptive type is selected
- *	@param type type of scheduling method selected enum[1,2,3,4]
+ *	@param type type of scheduling method selected enum[1,2,3,4,5]
  *	@param TQ quantam time value if type = 4 | Round-Robin Algorithm
  *
  *	@return void
  */
-int displayMenu(bool premtive = false, int type = 0, float TQ = 0)
+int displayMenu(bool premtive = false, int type = 0, double TQ = 0)
 {
 	int option = 0;
 	std::string scheduling_method = "None";
@@ -342,6 +1979,9 @@ int displayMenu(bool premtive = false, int type = 0, float TQ = 0)
 	case 4:
 		scheduling_method = "RR";
 		break;
+	case 5:
+		scheduling_method = "CFS";
+		break;
 	default:
 		scheduling_method = "None";
 		break;
@@ -378,6 +2018,7 @@ int displaySchedulingMenu()
 	std::cout << " [2]: Shortest Job First " << std::endl;
 	std::cout << " [3]: Priority " << std::endl;
 	std::cout << " [4]: Round-Ribbon " << std::endl;
+	std::cout << " [5]: Completely Fair (CFS) " << std::endl;
 	std::cout << std::endl;
 
 	std::cout << " --------------------------------------------------------------------------- " << std::endl;
@@ -392,9 +2033,9 @@ int displaySchedulingMenu()
 }
 
 /**
- * @brief create a process linked list with dynamic memory allocation
+ * @brief append a process to the workload table
  *
- * @param head <Process> struct | head of the linked list
+ * @param table <Workload> workload the process is appended to
  * @param pid	Process number
  * @param arrival_time Arrival time in miliseconds
  * @param burst_time Burst time in miliseconds
@@ -402,478 +2043,761 @@ int displaySchedulingMenu()
  *
  * @return void
  */
-void createProcess(Process **head, int pid, float arrival_time, float burst_time, int priority)
+void createProcess(Workload &table, int pid, Tick arrival_time, Tick burst_time, int priority)
 {
+	table.pid.push_back(pid);
+	table.arrival_time.push_back(arrival_time);
+	table.burst_time.push_back(burst_time);
+	table.priority.push_back(priority);
+}
 
-	// "new" is same a "malloc" function that will allocate memory for the process structure and return it as a pointer
-	Process *tail = *head, *current_node = new Process{pid, burst_time, arrival_time, priority, burst_time};
-
-	if (*head == NULL)
-		*head = current_node;
-	else
-	{
-		while (tail->next != NULL)
-			tail = tail->next;
-		tail->next = current_node;
-	}
+/**
+ * @brief append the waiting time of every process, in arrival order
+ *
+ * @param report buffer the results are appended to
+ * @param state state of a finished run
+ */
+void writeProcessLines(std::string &report, const ProcessState &state)
+{
+	for (int i : state.order)
+		writeProcessLine(report, processes.pid[i], state.waiting_time[i]);
 }
 
-float simulateFCFS()
+/**
+ * @brief append averages, extremes, slowdown and fairness of a run
+ *
+ * @param report buffer the results are appended to
+ * @param summary summary statistics of the run
+ */
+void writeSummary(std::string &report, const ResultSummary &summary)
 {
-	Process *current_node = sortLinkedList(head, "arrival_time");
-	float first_response = 0.0f, total_waiting_time = 0.0f;
-	while (current_node != nullptr)
+	static const char *names[SUMMARY_COLUMNS] = {"waiting", "turnaround", "response"};
+	static const char *titles[SUMMARY_COLUMNS] = {"Waiting", "Turnaround", "Response"};
+	char line[160];
+
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+		writeToReport(report, " > Average " + std::string(names[column]) + " time: " +
+															std::to_string(averageMilliseconds(summary.total[column], summary.count)) + "ms");
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
 	{
-		if (current_node->pid == 1)
-			first_response = current_node->arrival_time;
-
-		current_node->waiting_time = ((first_response + current_node->burst_time) - current_node->arrival_time) - current_node->burst_time;
-
-		writeToFile(" P" + std::to_string(current_node->pid) + ": " + std::to_string(current_node->waiting_time));
-
-		total_waiting_time += current_node->waiting_time;
-		first_response = first_response + current_node->burst_time;
-		current_node = current_node->next;
+		char minimum[48], maximum[48];
+		formatTicks(minimum, sizeof(minimum), summary.count ? summary.minimum[column] : 0, true);
+		formatTicks(maximum, sizeof(maximum), summary.count ? summary.maximum[column] : 0, true);
+		snprintf(line, sizeof(line), " > %s time min / max: %sms / %sms", titles[column], minimum, maximum);
+		writeToReport(report, line);
+	}
+	snprintf(line, sizeof(line), " > Slowdown average / max: %f / %f", summary.count ? summary.slowdown_total / summary.count : 0.0, summary.slowdown_max);
+	writeToReport(report, line);
+	// Jain's index: 1 when every process is slowed down equally, 1/N when one process gets all the delay
+	snprintf(line, sizeof(line), " > Fairness (Jain's index of slowdown): %f",
+					 summary.slowdown_square_total > 0 ? summary.slowdown_total * summary.slowdown_total / (summary.count * summary.slowdown_square_total) : 1.0);
+	writeToReport(report, line);
+
+	static const double percentiles[] = {50, 90, 99, 99.9};
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		std::string values;
+		for (double percentile : percentiles)
+		{
+			char value[48];
+			formatTicks(value, sizeof(value), summary.latency[column].percentile(percentile), true);
+			values += (values.empty() ? "" : " / ") + std::string(value);
+		}
+		writeToReport(report, " > " + std::string(titles[column]) + " time p50 / p90 / p99 / p99.9: " + values + "ms");
 	}
-
-	return total_waiting_time;
 }
 
 /**
- * @brief display results for first come first serve algorithm
+ * @brief simulate a configuration on the loaded workload, append its process lines, summarize and record its metrics
+ *
+ * @param name run name in the metrics report
+ * @param report buffer the process lines are appended to
+ * @param summary summary statistics of the run
+ * @param config scheduling method and settings
+ * @param result filled with the schedule
  *
  * @return void
  */
-void calculateFCFS()
+void runSimulation([[maybe_unused]] const std::string &name, std::string &report, ResultSummary &summary, const SchedulerConfig &config, Result &result)
 {
+	std::string error = checkConfig(processes, config);
+	if (!error.empty())
+		exitWithError(error);
 
-	writeToFile("--------------- Scheduling Method: First Come First Served ---------------");
-	writeToFile(" Process waiting times [ms]:");
-
-	float total_waiting_time = simulateFCFS();
-
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
-}
-
-float simulateSJFPreemptive()
-{
-	std::priority_queue<Process, std::vector<Process>, CompareRemainingTime> queue;
-	Process *current_node = head;
-	float total_waiting_time = 0.0f, current_time = 0.0f, elapsed_time = 0.0f;
-	// Add all the processes to the queue
-	while (current_node != NULL)
+	ProcessState &state = result.state;
 	{
-		queue.push(*current_node);
-		current_node = current_node->next;
+		METRIC_PHASE(simulate_timer, state.metrics.simulate_seconds);
+		simulate(processes, config, result);
 	}
-
-	// Run the algorithm until the queue is empty
-	while (!queue.empty())
 	{
-		// Get the process with the shortest remaining time
-		Process shortest = queue.top();
-		queue.pop();
-
-		// If the process has already completed, skip it
-		if (shortest.completed)
-			continue;
-		else
-		{
-			// Update the waiting time and turnaround time for the process
-			shortest.waiting_time += shortest.elapsed_time - shortest.arrival_time;
-			shortest.turnaround_time = shortest.waiting_time + shortest.burst_time;
-			shortest.completed = true;
-			shortest.completion_time = shortest.elapsed_time + shortest.burst_time;
-		}
-		writeToFile(" P" + std::to_string(shortest.pid) + ": " + std::to_string(shortest.waiting_time));
-
-		// Add the waiting time of the process to the total waiting time
-		total_waiting_time += shortest.waiting_time;
+		METRIC_PHASE(report_timer, state.metrics.report_seconds);
+		writeProcessLines(report, state);
+	}
+	{
+		METRIC_PHASE(aggregate_timer, state.metrics.aggregate_seconds);
+		summary = aggregateResults(state, processes);
+	}
 
-		// Update the elapsed time for the other processes in the queue
-		std::vector<Process> temp_queue;
-		while (!queue.empty())
-		{
-			Process p = queue.top();
-			queue.pop();
-			p.elapsed_time += shortest.burst_time;
-			temp_queue.push_back(p);
-		}
-		for (int i = 0; i < temp_queue.size(); i++)
-		{
-			queue.push(temp_queue[i]);
-		}
+#ifndef NO_METRICS
+	if (metrics_report.file_name != NULL)
+	{
+		state.metrics.context_switches = result.totals.context_switches;
+		std::lock_guard<std::mutex> guard(metrics_report.lock);
+		metrics_report.runs.push_back({name, state.metrics});
 	}
+#endif
+}
 
-	return total_waiting_time;
+/**
+ * @brief append the context switch count of a run
+ *
+ * @param report buffer the line is appended to
+ * @param result finished run
+ */
+void writeContextSwitches(std::string &report, const Result &result)
+{
+	writeToReport(report, " > Context switches: " + std::to_string(result.totals.context_switches));
 }
+
 /**
- * @brief display results for shortest job first algorithm (Non-Preemptive)
+ * @brief simulate a configuration on the loaded workload and append its results
+ *
+ * Writes the waiting time of every process and the summary; details
+ * appends the lines specific to the algorithm before the closing rule.
+ *
+ * @param report buffer the results are appended to
+ * @param name run name in the metrics report
+ * @param config scheduling method and settings
+ * @param details called with the report and the finished run
  *
  * @return void
  */
-void calculateSJFPremptive()
+template <class Details>
+void writeRunReport(std::string &report, const std::string &name, const SchedulerConfig &config, Details details)
 {
+	writeToReport(report, " Process waiting times [ms]:");
 
-	writeToFile("---------- Scheduling Method: Shortest Job First ( Preemptive ) ----------");
-	writeToFile(" Process waiting times [ms]:");
-
-	float total_waiting_time = simulateSJFPreemptive();
+	ResultSummary summary;
+	Result result;
+	runSimulation(name, report, summary, config, result);
 
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
+	writeToReport(report, "--------------------------------------------------------------------------");
+	writeSummary(report, summary);
+	details(report, result);
+	writeToReport(report, "--------------------------------------------------------------------------");
 }
 
-float simulateSJFNonPremptive()
+/**
+ * @brief display results for first come first serve algorithm
+ *
+ * @param report buffer the results are appended to
+ *
+ * @return void
+ */
+void calculateFCFS(std::string &report)
 {
-
-	float total_waiting_time = 0.0f, elapsed_time = 0.0f;
-
-	// Create a copy of the original process list
-	Process *sorted = sortLinkedList(head, "arrival_time");
-	Process *processList = sorted;
-
-	// Initialize variables
-	int currentTime = 0;
-	Process *currentProcess = NULL;
-
-	// Keep track of completed processes
-	std::vector<int> completedProcesses;
-
-	// Iterate until all processes have completed
-	while (completedProcesses.size() < TOTAL_PROCESS)
-	{
-		// Get the next process with the shortest remaining burst time
-		currentProcess = getNextShortestProcess(processList, currentTime, completedProcesses);
-
-		// Update the waiting time for the current process
-		currentProcess->waiting_time = currentTime - currentProcess->arrival_time;
-		total_waiting_time += currentProcess->waiting_time;
-
-		// Update the elapsed time for the current process
-		currentProcess->elapsed_time = currentProcess->waiting_time + currentProcess->burst_time;
-
-		// Update the current time
-		currentTime += currentProcess->burst_time;
-
-		// Mark the current process as completed
-		completedProcesses.push_back(currentProcess->pid);
-	}
-	// Reset the processList pointer to the first node
-	processList = sorted;
-	Process *temp = processList;
-	while (temp != NULL)
-	{
-		writeToFile(" P" + std::to_string(temp->pid) + ": " + std::to_string(temp->waiting_time));
-		temp = temp->next;
-	}
-
-	return total_waiting_time;
+	writeToReport(report, "--------------- Scheduling Method: First Come First Served ---------------");
+	writeRunReport(report, "FCFS", createSchedulerConfig(ALGORITHM_FCFS, ticks_per_ms), [](std::string &, const Result &) {});
 }
 
 /**
- * @brief display results for Shortest Job First algorithm (Preemptive)
+ * @brief display results for shortest job first algorithm (Preemptive)
+ *
+ * @param report buffer the results are appended to
  *
  * @return void
  */
-void calculateSJFNonPremptive()
+void calculateSJFPremptive(std::string &report)
 {
-	writeToFile("-------- Scheduling Method: Shortest Job First ( Non-Preemptive ) --------");
-	writeToFile(" Process waiting times [ms]:");
-
-	float total_waiting_time = simulateSJFNonPremptive();
-
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
+	writeToReport(report, "---------- Scheduling Method: Shortest Job First ( Preemptive ) ----------");
+	writeRunReport(report, "SJF-P", createSchedulerConfig(ALGORITHM_SRTF, ticks_per_ms), writeContextSwitches);
 }
 
-float simulateProrityNonPreemptive()
+/**
+ * @brief display results for Shortest Job First algorithm (Non-Preemptive)
+ *
+ * @param report buffer the results are appended to
+ *
+ * @return void
+ */
+void calculateSJFNonPremptive(std::string &report)
 {
-	float total_waiting_time = 0.0f, elapsed_time = 0.0f;
-
-	// Create a copy of the original process list
-	Process *sorted = sortLinkedList(head, "priority");
-	Process *processList = sorted;
+	writeToReport(report, "-------- Scheduling Method: Shortest Job First ( Non-Preemptive ) --------");
+	writeRunReport(report, "SJF-NP", createSchedulerConfig(ALGORITHM_SJF, ticks_per_ms), [](std::string &, const Result &) {});
+}
 
-	// Initialize variables
-	int currentTime = 0;
-	Process *currentProcess = NULL;
+/**
+ * @brief display results for priority scheduling algorithm (Non-Preemptive)
+ *
+ * @param report buffer the results are appended to
+ *
+ * @return void
+ */
+void calculatePriorityNonPreemptive(std::string &report)
+{
+	writeToReport(report, "------------- Scheduling Method: Priority ( Non-Preemptive ) -------------");
+	writeRunReport(report, "Priority-NP", createSchedulerConfig(ALGORITHM_PRIORITY, ticks_per_ms), writeContextSwitches);
+}
 
-	// Keep track of completed processes
-	std::vector<int> completedProcesses;
+/**
+ * @brief display results for priority scheduling algorithm (Preemptive)
+ *
+ * @param report buffer the results are appended to
+ *
+ * @return void
+ */
+void calculatePriorityPreemptive(std::string &report)
+{
+	writeToReport(report, "--------------- Scheduling Method: Priority ( Preemptive ) ---------------");
+	writeRunReport(report, "Priority-P", createSchedulerConfig(ALGORITHM_PRIORITY_PREEMPTIVE, ticks_per_ms), writeContextSwitches);
+}
 
-	// Iterate until all processes have completed
-	while (completedProcesses.size() < TOTAL_PROCESS)
+/**
+ * @brief display results for Round Robin scheduling algorithm
+ *
+ * @param report buffer the results are appended to
+ * @param TQ time quantum
+ *
+ * @return void
+ */
+void calculateRoundRobin(std::string &report, double TQ)
+{
+	writeToReport(report, "------------ Scheduling Method: Round Robin ( TQ = " + std::to_string(TQ) + " ) ------------ ");
+	if (TQ <= 0)
 	{
-		// Get the next process with the shortest remaining burst time
-		currentProcess = getNextShortestProcess(processList, currentTime, completedProcesses);
-
-		// Update the waiting time for the current process
-		currentProcess->waiting_time = currentTime - currentProcess->arrival_time;
-		total_waiting_time += currentProcess->waiting_time;
-
-		// Update the elapsed time for the current process
-		currentProcess->elapsed_time = currentProcess->waiting_time + currentProcess->burst_time;
-
-		// Update the current time
-		currentTime += currentProcess->burst_time;
-
-		// Mark the current process as completed
-		completedProcesses.push_back(currentProcess->pid);
+		writeToReport(report, " > Quantum time must be greater than zero");
+		writeToReport(report, "--------------------------------------------------------------------------");
+		return;
 	}
-
-	// Reset the processList pointer to the first node
-	processList = sorted;
-	Process *temp = processList;
-	while (temp != NULL)
+	SchedulerConfig config = createSchedulerConfig(ALGORITHM_ROUND_ROBIN, ticks_per_ms);
+	config.quantum = ticksFromMilliseconds(TQ);
+	if (config.quantum < 1)
 	{
-		writeToFile(" P" + std::to_string(temp->pid) + ": " + std::to_string(temp->waiting_time));
-		temp = temp->next;
+		writeToReport(report, " > Quantum time is shorter than one tick, use a finer --resolution");
+		writeToReport(report, "--------------------------------------------------------------------------");
+		return;
 	}
 
-	return total_waiting_time;
+	writeRunReport(report, "RR (TQ = " + std::to_string(TQ) + ")", config, writeContextSwitches);
 }
+
 /**
- * @brief display results for priority scheduling algorithm (Non-Preemptive)
+ * @brief sweep round robin over many quantum values and print one summary table
+ *
+ * Every quantum is an independent run over the shared workload, so they
+ * are spread over the worker threads; the table keeps the given order.
+ *
+ * @param report buffer the table is appended to
+ * @param quantums quantum values to simulate
+ * @param thread_count number of worker threads (0 = one per core)
  *
  * @return void
  */
-void calculatePriorityNonPreemptive()
+void calculateRoundRobinSweep(std::string &report, const std::vector<double> &quantums, unsigned thread_count)
 {
-	writeToFile("------------- Scheduling Method: Priority ( Non-Preemptive ) -------------");
-	writeToFile(" Process waiting times [ms]:");
-
-	float total_waiting_time = simulateProrityNonPreemptive();
-
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
+	std::vector<SimulationResult> results(quantums.size());
+	std::vector<Tick> tail_waiting_time(quantums.size());
+	runParallel(quantums.size(), thread_count, [&](size_t run)
+							{
+		SchedulerConfig config = createSchedulerConfig(ALGORITHM_ROUND_ROBIN, ticks_per_ms);
+		config.quantum = ticksFromMilliseconds(quantums[run]);
+		Result result;
+		simulate(processes, config, result);
+		results[run] = result.totals;
+		LatencyHistogram waiting;
+		for (Tick waiting_time : result.state.waiting_time)
+			waiting.record(waiting_time);
+		tail_waiting_time[run] = waiting.percentile(99); });
+
+	writeToReport(report, "------------------- Round Robin quantum sweep ( " + std::to_string(quantums.size()) + " runs ) -------------------");
+	writeToReport(report, "            TQ    Avg waiting    p99 waiting  Avg turnaround   Avg response  Context switches");
+	for (size_t run = 0; run < quantums.size(); run++)
+	{
+		char line[160];
+		snprintf(line, sizeof(line), " %13f %14f %14f %15f %14f %17lld", quantums[run],
+						 averageMilliseconds(results[run].total_waiting_time, TOTAL_PROCESS),
+						 (double)tail_waiting_time[run] / ticks_per_ms,
+						 averageMilliseconds(results[run].total_turnaround_time, TOTAL_PROCESS),
+						 averageMilliseconds(results[run].total_response_time, TOTAL_PROCESS),
+						 results[run].context_switches);
+		writeToReport(report, line);
+	}
+	writeToReport(report, "--------------------------------------------------------------------------");
 }
 
-void calculatePriorityPreemptive()
+/**
+ * @brief display results for the completely fair scheduler
+ *
+ * @param report buffer the results are appended to
+ * @param min_granularity shortest slice in ms
+ *
+ * @return void
+ */
+void calculateFair(std::string &report, double min_granularity)
 {
-
-	Process *sorted = sortLinkedList(head, "priority");
-
-	writeToFile("---------- Scheduling Method: Prority ( Preemptive ) ----------");
-	writeToFile(" Process waiting times [ms]:");
-
-	float total_waiting_time = 0.0f;
-
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
+	writeToReport(report, "------ Scheduling Method: Completely Fair ( min granularity = " + std::to_string(min_granularity) + " ) ------");
+	SchedulerConfig config = createSchedulerConfig(ALGORITHM_FAIR, ticks_per_ms);
+	config.min_granularity = ticksFromMilliseconds(min_granularity);
+	if (config.min_granularity < 1)
+	{
+		writeToReport(report, " > Minimum granularity is shorter than one tick, use a finer --resolution");
+		writeToReport(report, "--------------------------------------------------------------------------");
+		return;
+	}
+	writeRunReport(report, "CFS (min granularity = " + std::to_string(min_granularity) + ")", config, writeContextSwitches);
 }
 
 /**
- * @brief display results for Round Robin scheduling algorithm
+ * @brief display results for the multilevel feedback queue
+ *
+ * @param report buffer the results are appended to
+ * @param quantums quantum of every level, top level first
+ * @param boost_period time between boosts to the top level, 0 for none
  *
  * @return void
  */
-void calculateRoundRobin(float TQ)
+void calculateFeedback(std::string &report, const std::vector<double> &quantums, double boost_period)
 {
-	float total_waiting_time = 0.0f;
-	writeToFile("------------ Scheduling Method: Round Robin ( TQ = " + std::to_string(TQ) + " ) ------------ ");
-	writeToFile(" Process waiting times [ms]:");
-
-	std::priority_queue<Process, std::vector<Process>, CompareArrivalTimeAndPriority> queue;
-	Process *current_node = head;
-
-	// Add all the processes to the queue
-	while (current_node != NULL)
+	SchedulerConfig config = createSchedulerConfig(ALGORITHM_FEEDBACK, ticks_per_ms);
+	std::string levels;
+	for (double quantum : quantums)
 	{
-		current_node->waiting_time = 0;
-		queue.push(*current_node);
-		current_node = current_node->next;
+		char value[32];
+		snprintf(value, sizeof(value), "%g", quantum);
+		levels += (levels.empty() ? "" : ",") + std::string(value);
+		config.mlfq_quantums.push_back(ticksFromMilliseconds(quantum));
 	}
+	config.boost_period = ticksFromMilliseconds(boost_period);
+	std::string settings = "TQ = " + levels + ", boost = " + (boost_period > 0 ? std::to_string(boost_period) : "off");
+	writeToReport(report, "------ Scheduling Method: Multilevel Feedback Queue ( " + settings + " ) ------");
+
+	writeRunReport(report, "MLFQ (" + settings + ")", config, [&](std::string &report, const Result &result)
+								 {
+		const FeedbackRun &run = result.feedback;
+		writeContextSwitches(report, result);
+		writeToReport(report, " > Demotions: " + std::to_string(run.demotions) + ", boosts: " + std::to_string(run.boosts));
+		for (size_t level = 0; level < quantums.size(); level++)
+		{
+			char line[96];
+			snprintf(line, sizeof(line), " > Level %zu (TQ = %gms): %lld processes finished here", level, quantums[level], run.completed[level]);
+			writeToReport(report, line);
+		} });
+}
 
-	// Run the algorithm until the queue is empty
-	while (!queue.empty())
-	{
-		// Get the next process in the queue
-		Process p = queue.top();
-		queue.pop();
-
-		// If the process has already completed, skip it
-		if (p.completed)
-			continue;
-
-		// Decrement the remaining time of the process by the time quantum
-		p.remaining_time -= TQ;
-		p.elapsed_time += TQ;
+/**
+ * @brief display results of a multi-core run with per-core utilization
+ *
+ * @param report buffer the results are appended to
+ * @param algorithm "fcfs", "sjf", "prio" or "rr"
+ * @param TQ time quantum for round robin
+ * @param smp core count and run queue layout
+ *
+ * @return void
+ */
+void calculateMultiCore(std::string &report, std::string algorithm, double TQ, smp_options smp)
+{
+	std::string title = algorithm == "fcfs"		? "First Come First Served"
+											: algorithm == "sjf"	? "Shortest Job First"
+											: algorithm == "prio" ? "Priority"
+																						: "Round Robin ( TQ = " + std::to_string(TQ) + " )";
+	std::string layout = smp.global_queue ? "global queue" : smp.steal ? "per-core queues, work stealing"
+																																		 : "per-core queues";
+	writeToReport(report, "------ Scheduling Method: " + title + " ( " + std::to_string(smp.cpus) + " CPUs, " + layout + " ) ------");
+
+	std::string name = algorithm == "fcfs"		? "FCFS"
+										 : algorithm == "sjf"	? "SJF-NP"
+										 : algorithm == "prio" ? "Priority-NP"
+																					 : "RR (TQ = " + std::to_string(TQ) + ")";
+	SchedulerConfig config = createSchedulerConfig(algorithm == "fcfs"		? ALGORITHM_FCFS
+																								 : algorithm == "sjf"	? ALGORITHM_SJF
+																								 : algorithm == "prio" ? ALGORITHM_PRIORITY
+																																			 : ALGORITHM_ROUND_ROBIN,
+																								 ticks_per_ms);
+	config.quantum = algorithm == "rr" ? ticksFromMilliseconds(TQ) : 0;
+	config.smp = smp;
+
+	writeRunReport(report, name + " (" + std::to_string(smp.cpus) + " CPUs)", config, [](std::string &report, const Result &result)
+								 {
+		const MultiCoreRun &run = result.multi_core;
+		writeToReport(report, " > Context switches: " + std::to_string(result.totals.context_switches) + ", migrations: " + std::to_string(run.migrations));
+		for (size_t core = 0; core < run.cores.size(); core++)
+		{
+			const CoreStats &stats = run.cores[core];
+			char line[160];
+			snprintf(line, sizeof(line), " > CPU %zu: utilization %.2f%%, dispatches %lld, completed %lld, steals %lld", core,
+							 run.makespan > 0 ? 100.0 * stats.busy_time / run.makespan : 0.0, stats.dispatches, stats.completed, stats.steals);
+			writeToReport(report, line);
+		} });
+}
 
-		// If the process has completed, update its waiting time and turnaround time
-		if (p.remaining_time <= 0)
+/**
+ * @brief simulate an arrival ordered workload straight from the file
+ *
+ * Only jobs that have arrived but not finished are kept, in a pool of
+ * recycled slots, so memory is bounded by the queue depth instead of the
+ * trace length. Results are emitted as jobs complete, in completion order.
+ *
+ * @param stream record source
+ * @param report buffer for per-job lines, handed to the output when large
+ * @param TQ time quantum, 0 to run every job to completion
+ * @param peak_jobs largest number of jobs held in memory at once
+ * @param summary statistics of the completed jobs, in constant memory
+ *
+ * @return SimulationResult run totals
+ */
+template <class ReadyQueue>
+SimulationResult simulateStream(RecordStream &stream, std::string &report, Tick TQ, size_t &peak_jobs, ResultSummary &summary)
+{
+	std::vector<StreamJob> jobs;
+	std::vector<int> free_slots;
+	ReadyQueue ready(jobs);
+	SimulationResult result{0, 0, 0, 0};
+	long long completed = 0;
+
+	StreamJob pending;
+	bool has_pending = stream.next(pending);
+	Tick current_time = 0;
+	int last_pid = -1;
+
+	// Move every job that has arrived by now from the file into the ready queue.
+	// Simultaneous arrivals enter in the same order as sortProcesses(SORT_BY_ARRIVAL).
+	std::vector<int> arrivals;
+	auto admitArrivals = [&]()
+	{
+		arrivals.clear();
+		for (; has_pending && pending.arrival_time <= current_time; has_pending = stream.next(pending))
 		{
-			p.waiting_time = p.elapsed_time - p.arrival_time;
-			p.turnaround_time = p.waiting_time + p.burst_time;
-			p.completed = true;
-			p.completion_time = p.elapsed_time;
-			writeToFile(" P" + std::to_string(p.pid) + ": " + std::to_string(p.waiting_time));
+			int slot;
+			if (free_slots.empty())
+			{
+				slot = jobs.size();
+				jobs.push_back(pending);
+			}
+			else
+			{
+				slot = free_slots.back();
+				free_slots.pop_back();
+				jobs[slot] = pending;
+			}
+			arrivals.push_back(slot);
 		}
-		// Otherwise, add the process back to the end of the queue
-		else
+		std::sort(arrivals.begin(), arrivals.end(), [&](int j1, int j2)
+							{
+			const StreamJob &p1 = jobs[j1], &p2 = jobs[j2];
+			if (p1.arrival_time != p2.arrival_time)
+				return p1.arrival_time < p2.arrival_time;
+			if (p1.priority != p2.priority)
+				return p1.priority > p2.priority;
+			return p1.pid < p2.pid; });
+		for (int slot : arrivals)
+			ready.push(slot);
+		peak_jobs = std::max(peak_jobs, jobs.size() - free_slots.size());
+	};
+
+	while (has_pending || !ready.empty())
+	{
+		// CPU is idle: fast-forward to the next arrival
+		if (ready.empty() && current_time < pending.arrival_time)
+			current_time = pending.arrival_time;
+		admitArrivals();
+
+		int current = ready.pop();
+		StreamJob &job = jobs[current];
+		if (last_pid != -1 && last_pid != job.pid)
+			result.context_switches++;
+		last_pid = job.pid;
+		if (job.response_time < 0)
 		{
-			queue.push(p);
+			job.response_time = current_time - job.arrival_time;
+			result.total_response_time += job.response_time;
 		}
 
-		// Add the waiting time of the process to the total waiting time
-		total_waiting_time += p.waiting_time;
-	}
-	writeToFile("--------------------------------------------------------------------------");
-	writeToFile(" > Average waiting time: " + std::to_string(total_waiting_time / TOTAL_PROCESS) + "ms");
-	writeToFile("--------------------------------------------------------------------------");
-}
+		Tick slice = job.remaining_time;
+		if (TQ > 0 && !ready.empty())
+			slice = std::min(TQ, slice);
+		else if (TQ > 0 && has_pending && pending.arrival_time < current_time + slice)
+		{
+			// Alone on the CPU: skip whole quanta up to the next arrival
+			Tick quanta = (pending.arrival_time - current_time + TQ - 1) / TQ;
+			slice = std::min(slice, std::max<Tick>(quanta, 1) * TQ);
+		}
 
-/**
- * @brief get the higest priority node from process list
- * @param node
- * @param currentTime
- * @param completedProcesses
- * @return
- */
-Process *getNextHighestPriorityProcess(Process *head, int currentTime, std::vector<int> completedProcesses)
-{
-	Process *highestPriorityProcess = NULL;
-	Process *temp = head;
+		current_time += slice;
+		jobs[current].remaining_time -= slice;
+		admitArrivals();
 
-	while (temp != NULL)
-	{
-		// Skip completed processes
-		if (std::find(completedProcesses.begin(), completedProcesses.end(), temp->pid) != completedProcesses.end())
+		if (jobs[current].remaining_time > 0)
 		{
-			temp = temp->next;
+			ready.push(current);
 			continue;
 		}
 
-		// If the current process has the highest priority and has arrived at the current time, set it as the highest priority process
-		if (highestPriorityProcess == NULL ||
-				temp->priority > highestPriorityProcess->priority)
+		// Completed: report it and give its slot back
+		const StreamJob &done = jobs[current];
+		Tick turnaround_time = current_time - done.arrival_time;
+		Tick waiting_time = turnaround_time - done.burst_time;
+		result.total_waiting_time += waiting_time;
+		result.total_turnaround_time += turnaround_time;
+		addResult(summary, completed, waiting_time, turnaround_time, done.response_time, done.burst_time);
+		summary.latency[SUMMARY_WAITING].record(waiting_time);
+		summary.latency[SUMMARY_TURNAROUND].record(turnaround_time);
+		summary.latency[SUMMARY_RESPONSE].record(done.response_time);
+		free_slots.push_back(current);
+
+		writeProcessLine(report, done.pid, waiting_time);
+		if (++completed % STREAM_PROGRESS_INTERVAL == 0)
+			writeToReport(report, " > " + std::to_string(completed) + " jobs done, average waiting time: " +
+																std::to_string(averageMilliseconds(result.total_waiting_time, completed)) + "ms");
+		if (report.size() >= OUTPUT_BUFFER_SIZE)
 		{
-			highestPriorityProcess = temp;
+			writeOutput(report);
+			report.clear();
 		}
-
-		temp = temp->next;
 	}
 
-	return highestPriorityProcess;
+	return result;
 }
 
 /**
- * @brief get the shortest job node from process list
- * @param node
- * @param currentTime
- * @param completedProcesses
- * @return
+ * @brief display results of a streaming run over an arrival ordered text workload
+ *
+ * @param algorithm "fcfs", "sjf", "prio" or "rr"
+ * @param TQ time quantum for round robin
+ * @param input_file_name text workload, records in arrival order
+ *
+ * @return void
  */
-Process *getNextShortestProcess(Process *node, int currentTime, std::vector<int> completedProcesses)
+void calculateStream(std::string algorithm, double TQ, std::string input_file_name)
 {
-	Process *shortestProcess = NULL;
-	Process *temp = node;
-
-	while (temp != NULL)
-	{
-		// Skip completed processes
-		if (std::find(completedProcesses.begin(), completedProcesses.end(), temp->pid) != completedProcesses.end())
-		{
-			temp = temp->next;
-			continue;
-		}
+	std::string report;
+	std::string title = algorithm == "fcfs"		? "First Come First Served"
+											: algorithm == "sjf"	? "Shortest Job First"
+											: algorithm == "prio" ? "Priority"
+																						: "Round Robin ( TQ = " + std::to_string(TQ) + " )";
+	writeToReport(report, "------ Scheduling Method: " + title + " ( Streaming ) ------");
+	writeToReport(report, " Process waiting times [ms] (completion order):");
+
+	RecordStream stream(input_file_name);
+	size_t peak_jobs = 0;
+	ResultSummary summary = createResultSummary();
+	SimulationResult result;
+	if (algorithm == "fcfs")
+		result = simulateStream<StreamFifo>(stream, report, 0, peak_jobs, summary);
+	else if (algorithm == "sjf")
+		result = simulateStream<StreamHeap<CompareStreamShortestBurst>>(stream, report, 0, peak_jobs, summary);
+	else if (algorithm == "prio")
+		result = simulateStream<StreamHeap<CompareStreamPriority>>(stream, report, 0, peak_jobs, summary);
+	else
+		result = simulateStream<StreamFifo>(stream, report, ticksFromMilliseconds(TQ), peak_jobs, summary);
+
+	int total = stream.next_pid;
+	summary.count = total;
+	finishSummary(summary);
+	writeToReport(report, "--------------------------------------------------------------------------");
+	writeToReport(report, " > Processes: " + std::to_string(total) + ", peak jobs in memory: " + std::to_string(peak_jobs));
+	writeSummary(report, summary);
+	writeToReport(report, " > Context switches: " + std::to_string(result.context_switches));
+	writeToReport(report, "--------------------------------------------------------------------------");
+	writeOutput(report);
+}
 
-		// If the current process has the shortest remaining burst time and has arrived at the current time, set it as the shortest process
-		if (shortestProcess == NULL || (temp->burst_time - temp->elapsed_time < shortestProcess->burst_time - shortestProcess->elapsed_time && temp->arrival_time <= currentTime))
-		{
-			shortestProcess = temp;
-		}
+/* -------------------------------------------------------------------------- */
+/*                  Benchmarks (compiled with -DBENCHMARK only)               */
+/* -------------------------------------------------------------------------- */
+#ifdef BENCHMARK
 
-		temp = temp->next;
-	}
+// Every heap allocation made by the program goes through these counters
+std::atomic<size_t> allocation_count{0};
+std::atomic<size_t> allocated_bytes{0};
 
-	return shortestProcess;
+void *operator new(size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	if (void *memory = malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
 }
 
+__attribute__((noinline)) void operator delete(void *memory) noexcept { free(memory); }
+__attribute__((noinline)) void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+// One measured case of the benchmark run
+struct BenchmarkResult
+{
+	std::string name;
+	size_t jobs;
+	double seconds;
+	size_t allocations;
+	size_t bytes;
+	long peak_rss_kb;
+};
+
 /**
- * @brief swap nodes
- * @param current_node
- * @param compare_node
+ * @brief time one case and record its allocations and the peak resident set so far
+ *
+ * @param results list the measurement is appended to
+ * @param name case name
+ * @param jobs workload size
+ * @param body code being measured
+ *
+ * @return void
  */
-void swapNodes(Process *current_node, Process *compare_node)
+void measure(std::vector<BenchmarkResult> &results, std::string name, size_t jobs, const std::function<void()> &body)
 {
-	std::swap(current_node->arrival_time, compare_node->arrival_time);
-	std::swap(current_node->burst_time, compare_node->burst_time);
-	std::swap(current_node->pid, compare_node->pid);
-	std::swap(current_node->priority, compare_node->priority);
-	std::swap(current_node->remaining_time, compare_node->remaining_time);
-	std::swap(current_node->waiting_time, compare_node->waiting_time);
-	std::swap(current_node->turnaround_time, compare_node->turnaround_time);
-	std::swap(current_node->completion_time, compare_node->completion_time);
+	size_t allocations = allocation_count, bytes = allocated_bytes;
+	auto start = std::chrono::steady_clock::now();
+	body();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	results.push_back({name, jobs, seconds, allocation_count - allocations, allocated_bytes - bytes, usage.ru_maxrss});
+
+	const BenchmarkResult &r = results.back();
+	printf(" %-10s %11zu %12.2f %12zu %14zu %12ld\n", r.name.c_str(), r.jobs, r.seconds * 1e9 / std::max<size_t>(jobs, 1),
+				 r.allocations, r.bytes, r.peak_rss_kb);
+	fflush(stdout);
 }
 
 /**
- * @brief
- * @param list node head
- * @param method ["arrival_time"]
- * @return Process
+ * @brief stop the benchmark when a vector aggregation kernel disagrees with the scalar one
+ *
+ * @param state state of a finished run
+ * @param table workload the run used
+ *
+ * @return void
  */
-Process *sortLinkedList(Process *list, std::string method)
+void checkKernels(const ProcessState &state, const Workload &table)
 {
-	// Check if the linked list is empty
-	if (list == nullptr)
-		return nullptr;
+	std::string kernel = checkAggregateKernels(state, table);
+	if (!kernel.empty())
+		exitWithError("the " + kernel + " aggregation kernel disagrees with the scalar one");
+}
 
-	// Create a copy of the linked list
-	Process *copy_head = nullptr;
-	Process *copy_tail = nullptr;
-	Process *current_node = list;
+/**
+ * @brief run every engine, the parser and the sort over generated workloads of growing size
+ *
+ * Usage: bench.exe [--min n] [--max n] [--tq q] [--seed s] [-o results.json]
+ * Sizes are the powers of ten from --min to --max (defaults 10^3 and 10^7).
+ *
+ * @param argc Argument count (contains the number of arguments)
+ * @param argv Argument vector (contains argument's values)
+ *
+ * @return int EXIT_SUCCESS
+ */
+int runBenchmarks(int argc, char *argv[])
+{
+	long long min_jobs = 1000, max_jobs = 10000000;
+	double TQ = 4.0;
+	std::string json_file_name = "bench.json";
+	generator_options generator{0, NULL, 1, ARRIVAL_POISSON, 0.2, 1, BURST_EXPONENTIAL, {4.0, 0, 0}, PRIORITY_UNIFORM, 0, 9, {}};
 
-	while (current_node != nullptr)
+	for (int i = 1; i + 1 < argc; i++)
 	{
-		if (copy_head == nullptr)
-		{
-			copy_head = new Process{current_node->pid, current_node->burst_time, current_node->arrival_time, current_node->priority};
-			copy_tail = copy_head;
-		}
-		else
-		{
-			copy_tail->next = new Process{current_node->pid, current_node->burst_time, current_node->arrival_time, current_node->priority};
-			copy_tail->next->prev = copy_tail;
-			copy_tail = copy_tail->next;
-		}
-		current_node = current_node->next;
+		std::string option = argv[i];
+		if (option == "--min")
+			min_jobs = atoll(argv[++i]);
+		else if (option == "--max")
+			max_jobs = atoll(argv[++i]);
+		else if (option == "--tq")
+			TQ = atof(argv[++i]);
+		else if (option == "--seed")
+			generator.seed = strtoull(argv[++i], NULL, 10);
+		else if (option == "-o")
+			json_file_name = argv[++i];
 	}
-
-	// Initialize variables to track the nodes being compared
-	current_node = copy_head;
-	Process *compare_node = current_node->next;
-
-	// Iterate through the linked list
-	while (current_node != nullptr)
+	if (min_jobs < 1 || max_jobs < min_jobs || max_jobs > INT32_MAX || ticksFromMilliseconds(TQ) < 1)
+		exitWithError("benchmark needs 1 <= --min <= --max <= 2^31-1 and --tq of at least one tick");
+
+	// Times past 2^52 ticks, which the vector kernels must hand to the scalar one: every
+	// seventh row of the middle rows is huge, the rows around them are ordinary
+	Workload large;
+	ProcessState large_state;
+	for (int i = 0; i < 12000; i++)
 	{
-		compare_node = current_node->next;
-		while (compare_node != nullptr)
-		{
-			// TODO: Add support for different priorities
-			if (method.compare("arrival_time") == 0)
-				if (current_node->arrival_time > compare_node->arrival_time)
-					swapNodes(current_node, compare_node);
-
-			if (method.compare("priority") == 0)
-				if (current_node->priority < compare_node->priority)
-					swapNodes(current_node, compare_node);
+		uint64_t bits = (i + 1) * 0x9E3779B97F4A7C15ULL;
+		Tick burst_time = 1 + (Tick)(bits >> (i >= 4000 && i < 8000 && i % 7 == 0 ? 2 : 40));
+		Tick waiting_time = bits >> 36;
+		createProcess(large, i + 1, 0, burst_time, 0);
+		large_state.waiting_time.push_back(waiting_time);
+		large_state.turnaround_time.push_back(waiting_time + burst_time);
+		large_state.response_time.push_back(waiting_time);
+	}
+	checkKernels(large_state, large);
 
-			if (method.compare("burst_time") == 0)
-				if (current_node->burst_time > compare_node->burst_time)
-					swapNodes(current_node, compare_node);
+	std::string workload_file_name = json_file_name + ".workload.txt";
+	std::vector<BenchmarkResult> results;
+	printf(" %-10s %11s %12s %12s %14s %12s\n", "case", "jobs", "ns/job", "allocations", "bytes", "peak RSS kB");
 
-			compare_node = compare_node->next;
-		}
-		current_node = current_node->next;
+	for (long long jobs = min_jobs; jobs <= max_jobs; jobs *= 10)
+	{
+		generator.count = jobs;
+		processes.clear();
+		measure(results, "generate", jobs, [&]
+						{ generateWorkload(processes, generator, 0); });
+
+		writeTextWorkload(processes, workload_file_name, 0);
+		processes.clear();
+		measure(results, "parse", jobs, [&]
+						{ readInputFile(workload_file_name); });
+		unlink(workload_file_name.c_str());
+		// The later cases run on the parsed copy, so it must hold every generated job
+		if (processes.size() != (size_t)jobs)
+			exitWithError("benchmark workload round trip lost jobs (" + std::to_string(processes.size()) + " of " + std::to_string(jobs) + ")");
+
+		std::vector<int> order;
+		order.reserve(jobs);
+		measure(results, "sort", jobs, [&]
+						{ sortProcesses(processes, SORT_BY_ARRIVAL, order); });
+
+		std::vector<std::pair<std::string, SchedulerConfig>> engines = {
+				{"fcfs", createSchedulerConfig(ALGORITHM_FCFS, ticks_per_ms)},
+				{"sjf", createSchedulerConfig(ALGORITHM_SJF, ticks_per_ms)},
+				{"srtf", createSchedulerConfig(ALGORITHM_SRTF, ticks_per_ms)},
+				{"prio", createSchedulerConfig(ALGORITHM_PRIORITY, ticks_per_ms)},
+				{"prio-p", createSchedulerConfig(ALGORITHM_PRIORITY_PREEMPTIVE, ticks_per_ms)},
+				{"rr", createSchedulerConfig(ALGORITHM_ROUND_ROBIN, ticks_per_ms)},
+				{"cfs", createSchedulerConfig(ALGORITHM_FAIR, ticks_per_ms)},
+				{"mlfq", createSchedulerConfig(ALGORITHM_FEEDBACK, ticks_per_ms)},
+				{"rr-8cpu", createSchedulerConfig(ALGORITHM_ROUND_ROBIN, ticks_per_ms)},
+		};
+		engines[5].second.quantum = ticksFromMilliseconds(TQ);
+		engines[7].second.mlfq_quantums = {ticksFromMilliseconds(TQ), ticksFromMilliseconds(2 * TQ), ticksFromMilliseconds(4 * TQ)};
+		engines[7].second.boost_period = ticksFromMilliseconds(100 * TQ);
+		engines[8].second.quantum = ticksFromMilliseconds(TQ);
+		engines[8].second.smp = smp_options{8, false, true};
+
+		// One result for every engine, sized by an unmeasured run so the cases only count their own work
+		Result result;
+		simulate(processes, engines[0].second, result);
+		for (auto &engine : engines)
+			measure(results, engine.first, jobs, [&]
+							{ simulate(processes, engine.second, result); });
+
+		simulate(processes, engines[0].second, result);
+		measure(results, "aggregate", jobs, [&]
+						{ aggregateResults(result.state, processes); });
+		checkKernels(result.state, processes);
 	}
 
-	// Return a pointer to the head of the sorted copy
-	return copy_head;
+	std::ofstream json(json_file_name);
+	if (!json)
+		exitWithError("unable to open \"" + json_file_name + "\" for writing");
+	json << "{\n  \"time_quantum\": " << TQ << ",\n  \"seed\": " << generator.seed << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult &r = results[i];
+		char line[256];
+		snprintf(line, sizeof(line),
+						 "    {\"name\": \"%s\", \"jobs\": %zu, \"seconds\": %.9f, \"ns_per_job\": %.3f, "
+						 "\"allocations\": %zu, \"allocated_bytes\": %zu, \"peak_rss_kb\": %ld}%s\n",
+						 r.name.c_str(), r.jobs, r.seconds, r.seconds * 1e9 / r.jobs, r.allocations, r.bytes, r.peak_rss_kb,
+						 i + 1 < results.size() ? "," : "");
+		json << line;
+	}
+	json << "  ]\n}\n";
+	return EXIT_SUCCESS;
 }
+
+#endif
@@ -0,0 +1,2004 @@
+/**========================================================================
+ * @author         :  Muhammad Zaid Bari
+ * @email          :  zaidbari99@gmail.com
+ * @repo           :  https://github.com/zaidbari/cmpe351-project
+ * @createdOn      :  December 06, 2022
+ * @description    :	CPU scheduling simulation library, see scheduler.h
+ *========================================================================**/
+
+/* ------------------------------ Header files ------------------------------ */
+#include "scheduler.h"
+#include <atomic>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/* -------------------------- Variable definitaions ------------------------- */
+#define AGGREGATE_BLOCK 4096								 // jobs per aggregation block, bounds the int64 lane sums
+#define HISTOGRAM_PARALLEL_ROWS (1 << 20)		 // rows per worker when filling percentile histograms
+#define NICE_0_WEIGHT 1024													 // weight of priority 0, see niceWeight
+#define WHEEL_SLOT_BITS 6													 // 64 slots per timing wheel level
+#define WHEEL_LEVELS 11														 // 11 x 6 bits cover every tick value
+
+/* ------------------------- Structure definiations ------------------------- */
+// Ties are always broken by arrival, then priority, then pid. pid is unique, so
+// every comparator below is a strict total order and std::sort is stable.
+struct CompareByArrival
+{
+	const Workload *table;
+
+	bool operator()(int p1, int p2) const
+	{
+		if (table->arrival_time[p1] != table->arrival_time[p2])
+			return table->arrival_time[p1] < table->arrival_time[p2];
+		if (table->priority[p1] != table->priority[p2])
+			return table->priority[p1] > table->priority[p2];
+		return table->pid[p1] < table->pid[p2];
+	}
+};
+
+struct CompareByPriority
+{
+	const Workload *table;
+
+	bool operator()(int p1, int p2) const
+	{
+		if (table->priority[p1] != table->priority[p2])
+			return table->priority[p1] > table->priority[p2];
+		return CompareByArrival{table}(p1, p2);
+	}
+};
+
+struct CompareByBurst
+{
+	const Workload *table;
+
+	bool operator()(int p1, int p2) const
+	{
+		if (table->burst_time[p1] != table->burst_time[p2])
+			return table->burst_time[p1] < table->burst_time[p2];
+		return CompareByArrival{table}(p1, p2);
+	}
+};
+
+// Shortest remaining time first, ties broken like CompareByArrival
+struct CompareRemainingTime
+{
+	const Workload *table;
+	const ProcessState *state;
+
+	bool operator()(int p1, int p2) const
+	{
+		if (state->remaining_time[p1] != state->remaining_time[p2])
+			return state->remaining_time[p1] < state->remaining_time[p2];
+		return CompareByArrival{table}(p1, p2);
+	}
+};
+
+/**
+ * Binary min-heap of process indexes with a position map, so a queued
+ * process can have its key changed in place in O(log N) instead of being
+ * copied out and pushed back. Keys are read through the comparator: change
+ * the key first, then call update().
+ */
+template <class Compare>
+struct IndexedHeap
+{
+	Compare less;
+	std::vector<int> heap;
+	std::vector<int> position; // slot of each process in heap, -1 if not queued
+
+	IndexedHeap(Compare compare, size_t capacity) : less(compare), position(capacity, -1)
+	{
+		heap.reserve(capacity);
+	}
+
+	bool empty() const { return heap.empty(); }
+	size_t size() const { return heap.size(); }
+	int top() const { return heap.front(); }
+
+	void push(int process)
+	{
+		heap.push_back(process);
+		position[process] = heap.size() - 1;
+		siftUp(heap.size() - 1);
+	}
+
+	int pop()
+	{
+		int process = heap.front();
+		position[process] = -1;
+		heap.front() = heap.back();
+		heap.pop_back();
+		if (!heap.empty())
+		{
+			position[heap.front()] = 0;
+			siftDown(0);
+		}
+		return process;
+	}
+
+	void update(int process)
+	{
+		siftUp(position[process]);
+		siftDown(position[process]);
+	}
+
+private:
+	void place(size_t slot, int process)
+	{
+		heap[slot] = process;
+		position[process] = slot;
+	}
+
+	void siftUp(size_t slot)
+	{
+		int process = heap[slot];
+		while (slot > 0 && less(process, heap[(slot - 1) / 2]))
+		{
+			place(slot, heap[(slot - 1) / 2]);
+			slot = (slot - 1) / 2;
+		}
+		place(slot, process);
+	}
+
+	void siftDown(size_t slot)
+	{
+		int process = heap[slot];
+		size_t count = heap.size();
+		while (2 * slot + 1 < count)
+		{
+			size_t child = 2 * slot + 1;
+			if (child + 1 < count && less(heap[child + 1], heap[child]))
+				child++;
+			if (!less(heap[child], process))
+				break;
+			place(slot, heap[child]);
+			slot = child;
+		}
+		place(slot, process);
+	}
+};
+
+/**
+ * Ready queue for priority scheduling: one FIFO bucket per priority value,
+ * linked through the process indexes, plus a two-level bitmap of non-empty
+ * buckets. Push, pop and finding the highest priority are all O(1); a
+ * higher priority value runs first, equal priorities run in arrival order.
+ */
+struct PriorityBuckets
+{
+	int base_priority;						// priority stored in bucket 0
+	std::vector<int> first, last; // per bucket, -1 when empty
+	std::vector<int> next;				// next process in the same bucket
+	uint64_t summary;							// bit w set when bitmap[w] != 0
+	uint64_t bitmap[PRIORITY_LEVELS / 64];
+	size_t count;
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+
+	int topBucket() const
+	{
+		int word = 63 - __builtin_clzll(summary);
+		return word * 64 + 63 - __builtin_clzll(bitmap[word]);
+	}
+
+	int topPriority() const { return base_priority + topBucket(); }
+	int top() const { return first[topBucket()]; }
+
+	void pushBack(int process, int priority)
+	{
+		int bucket = priority - base_priority;
+		next[process] = -1;
+		if (first[bucket] == -1)
+		{
+			first[bucket] = process;
+			mark(bucket);
+		}
+		else
+			next[last[bucket]] = process;
+		last[bucket] = process;
+		count++;
+	}
+
+	// a preempted process goes back to the head of its bucket
+	void pushFront(int process, int priority)
+	{
+		int bucket = priority - base_priority;
+		next[process] = first[bucket];
+		if (first[bucket] == -1)
+		{
+			last[bucket] = process;
+			mark(bucket);
+		}
+		first[bucket] = process;
+		count++;
+	}
+
+	int pop()
+	{
+		int bucket = topBucket();
+		int process = first[bucket];
+		first[bucket] = next[process];
+		if (first[bucket] == -1)
+		{
+			last[bucket] = -1;
+			bitmap[bucket / 64] &= ~(1ULL << (bucket % 64));
+			if (bitmap[bucket / 64] == 0)
+				summary &= ~(1ULL << (bucket / 64));
+		}
+		count--;
+		return process;
+	}
+
+	// Move every queued process to the back of one bucket, highest bucket first,
+	// by splicing the lists: O(non-empty buckets), whatever the number of processes
+	void mergeInto(int priority)
+	{
+		int target = priority - base_priority;
+		for (uint64_t words = summary; words != 0; words &= ~(1ULL << (63 - __builtin_clzll(words))))
+		{
+			int word = 63 - __builtin_clzll(words);
+			for (uint64_t bits = bitmap[word]; bits != 0; bits &= ~(1ULL << (63 - __builtin_clzll(bits))))
+			{
+				int bucket = word * 64 + 63 - __builtin_clzll(bits);
+				if (bucket == target)
+					continue;
+				if (first[target] == -1)
+					first[target] = first[bucket];
+				else
+					next[last[target]] = first[bucket];
+				last[target] = last[bucket];
+				first[bucket] = last[bucket] = -1;
+			}
+			bitmap[word] = 0;
+		}
+		summary = 0;
+		if (first[target] != -1)
+			mark(target);
+	}
+
+private:
+	void mark(int bucket)
+	{
+		bitmap[bucket / 64] |= 1ULL << (bucket % 64);
+		summary |= 1ULL << (bucket / 64);
+	}
+};
+
+/**
+ * Heap of process indexes with the process that sorts first under Compare
+ * on top, for the per-core run queues of the multi-core engine (one
+ * PriorityBuckets per core would cost N links per core).
+ */
+template <class Compare>
+struct ProcessHeap
+{
+	struct Later
+	{
+		Compare compare;
+		bool operator()(int p1, int p2) const { return compare(p2, p1); }
+	};
+	Later later;
+	std::vector<int> heap;
+
+	ProcessHeap(Compare compare, size_t capacity) : later{compare} { heap.reserve(capacity); }
+
+	bool empty() const { return heap.empty(); }
+	size_t size() const { return heap.size(); }
+
+	void push(int process)
+	{
+		heap.push_back(process);
+		std::push_heap(heap.begin(), heap.end(), later);
+	}
+
+	int pop()
+	{
+		std::pop_heap(heap.begin(), heap.end(), later);
+		int process = heap.back();
+		heap.pop_back();
+		return process;
+	}
+};
+
+/**
+ * Hierarchical timing wheel of pending events, each event an id below the
+ * capacity with at most one pending time. Level l has 64 slots of 64^l
+ * ticks: an event goes to the level of the highest digit where its time
+ * differs from the wheel time, so a level 0 slot holds one exact time. The
+ * next event is a bitmap scan from the current digit; when level 0 has
+ * nothing left the first occupied slot above is spread over the lower
+ * levels. An event moves down at most WHEEL_LEVELS times, so insert and
+ * pop are amortized O(1) whatever the number of pending events. Events
+ * with the same time come out in no particular order, and no event may be
+ * inserted before the time of the last one taken out (there is no peek:
+ * looking for the next event can move the wheel time up to it).
+ */
+struct TimingWheel
+{
+	Tick now; // no pending event is earlier
+	std::vector<Tick> time;
+	std::vector<int> next; // next event in the same slot
+	int head[WHEEL_LEVELS][1 << WHEEL_SLOT_BITS];
+	uint64_t occupied[WHEEL_LEVELS];
+	size_t count;
+
+	TimingWheel(size_t capacity) : now(0), time(capacity), next(capacity), count(0)
+	{
+		std::fill(&head[0][0], &head[0][0] + WHEEL_LEVELS * (1 << WHEEL_SLOT_BITS), -1);
+		std::fill(occupied, occupied + WHEEL_LEVELS, 0);
+	}
+
+	bool empty() const { return count == 0; }
+
+	void insert(int event, Tick when)
+	{
+		time[event] = when;
+		place(event);
+		count++;
+	}
+
+	// another event is due at the time of the last one taken out: above level 0
+	// every event differs from the wheel time, so they all sit in its level 0 slot
+	bool dueNow() const { return (occupied[0] >> digit(now, 0)) & 1; }
+
+	// take out the next event and move the wheel time to it, the wheel must not be empty
+	int pop()
+	{
+		int slot = dueSlot();
+		int event = head[0][slot];
+		head[0][slot] = next[event];
+		if (head[0][slot] == -1)
+			occupied[0] &= ~(1ULL << slot);
+		now = time[event];
+		count--;
+		return event;
+	}
+
+private:
+	static int digit(Tick value, int level) { return ((uint64_t)value >> (level * WHEEL_SLOT_BITS)) & ((1 << WHEEL_SLOT_BITS) - 1); }
+
+	void place(int event)
+	{
+		uint64_t differ = (uint64_t)(time[event] ^ now);
+		int level = differ == 0 ? 0 : (63 - __builtin_clzll(differ)) / WHEEL_SLOT_BITS;
+		int slot = digit(time[event], level);
+		next[event] = head[level][slot];
+		head[level][slot] = event;
+		occupied[level] |= 1ULL << slot;
+	}
+
+	// level 0 slot of the next event, after moving the first occupied higher slot down if level 0 is empty
+	int dueSlot()
+	{
+		for (;;)
+		{
+			uint64_t due = occupied[0] & (~0ULL << digit(now, 0));
+			if (due != 0)
+				return __builtin_ctzll(due);
+
+			int level = 1;
+			while ((occupied[level] & (~0ULL << digit(now, level))) == 0)
+				level++;
+			int slot = __builtin_ctzll(occupied[level] & (~0ULL << digit(now, level)));
+
+			// The wheel time moves to the start of the slot, every event in it goes down a level or more
+			int shift = level * WHEEL_SLOT_BITS;
+			uint64_t below = shift + WHEEL_SLOT_BITS >= 64 ? ~0ULL : (1ULL << (shift + WHEEL_SLOT_BITS)) - 1;
+			now = std::max(now, (Tick)(((uint64_t)now & ~below) | (uint64_t)slot << shift));
+			int event = head[level][slot];
+			head[level][slot] = -1;
+			occupied[level] &= ~(1ULL << slot);
+			while (event != -1)
+			{
+				int following = next[event];
+				place(event);
+				event = following;
+			}
+		}
+	}
+};
+
+/**
+ * Ready queue policies of simulateSchedule. push() admits a process or
+ * takes back one whose quantum ran out, requeue() takes back a preempted
+ * one, and outranks() tells whether the head of the queue should take the
+ * CPU from the running process (only the preemptive queues have it).
+ */
+struct ArrivalOrder
+{
+	RingBuffer queue;
+
+	ArrivalOrder(const Workload &table, const ProcessState &) : queue(table.size()) {}
+
+	bool empty() const { return queue.empty(); }
+	size_t size() const { return queue.size(); }
+	void push(int process) { queue.push(process); }
+	void requeue(int process) { queue.push(process); }
+	int pop() { return queue.pop(); }
+};
+
+struct ShortestBurstFirst
+{
+	ProcessHeap<CompareByBurst> queue;
+
+	ShortestBurstFirst(const Workload &table, const ProcessState &) : queue(CompareByBurst{&table}, table.size()) {}
+
+	bool empty() const { return queue.empty(); }
+	size_t size() const { return queue.size(); }
+	void push(int process) { queue.push(process); }
+	void requeue(int process) { queue.push(process); }
+	int pop() { return queue.pop(); }
+};
+
+// Every queued process is keyed on its remaining time, so the running one must be requeued after its key changed
+struct ShortestRemainingFirst
+{
+	IndexedHeap<CompareRemainingTime> queue;
+
+	ShortestRemainingFirst(const Workload &table, const ProcessState &state) : queue(CompareRemainingTime{&table, &state}, table.size()) {}
+
+	bool empty() const { return queue.empty(); }
+	size_t size() const { return queue.size(); }
+	void push(int process) { queue.push(process); }
+	void requeue(int process) { queue.push(process); }
+	int pop() { return queue.pop(); }
+	bool outranks(int current) const { return !queue.empty() && queue.less(queue.top(), current); }
+};
+
+// Equal priorities run in arrival order, a preempted process goes back to the head of its bucket
+struct HighestPriorityFirst
+{
+	const Workload *table;
+	PriorityBuckets queue;
+
+	HighestPriorityFirst(const Workload &table, const ProcessState &state);
+
+	bool empty() const { return queue.empty(); }
+	size_t size() const { return queue.size(); }
+	void push(int process) { queue.pushBack(process, table->priority[process]); }
+	void requeue(int process) { queue.pushFront(process, table->priority[process]); }
+	int pop() { return queue.pop(); }
+	bool outranks(int current) const { return !queue.empty() && queue.topPriority() > table->priority[current]; }
+};
+
+// Preemption policies of simulateSchedule: whether an arrival can take the CPU from the running process
+struct NonPreemptive
+{
+	static constexpr bool on_arrival = false;
+
+	template <class ReadyQueue>
+	static bool preempts(const ReadyQueue &, int) { return false; }
+};
+
+struct PreemptOnArrival
+{
+	static constexpr bool on_arrival = true;
+
+	template <class ReadyQueue>
+	static bool preempts(const ReadyQueue &ready, int current) { return ready.outranks(current); }
+};
+
+/**
+ * Quantum policies of simulateSchedule: slice() is how long the dispatched
+ * process may run, given its remaining time, the time until the next
+ * arrival and whether it is the only runnable process.
+ */
+struct RunToCompletion
+{
+	Tick slice(Tick remaining, Tick, bool) const { return remaining; }
+};
+
+struct FixedQuantum
+{
+	Tick TQ;
+
+	Tick slice(Tick remaining, Tick next_arrival, bool alone) const
+	{
+		if (!alone)
+			return std::min(TQ, remaining);
+		// Alone on the CPU: keep running until the first quantum boundary at or after the next arrival
+		if (next_arrival < remaining)
+			return std::min(remaining, std::max<Tick>((next_arrival + TQ - 1) / TQ, 1) * TQ);
+		return remaining;
+	}
+};
+
+/**
+ * Intrusive red-black tree of process indexes ordered by virtual runtime,
+ * ties in arrival order, for the fair scheduler. The links are arrays
+ * indexed by process with one sentinel slot at the end, so nodes come from
+ * a pool sized once and inserting or erasing never allocates. The leftmost
+ * node is cached: the next process is found in O(1), inserts and erases
+ * cost O(log N).
+ */
+struct VruntimeTree
+{
+	const std::vector<Tick> *vruntime;
+	const std::vector<int> *rank; // position in arrival order
+	std::vector<int> left, right, parent;
+	std::vector<char> red;
+	int nil;			// sentinel slot
+	int root;
+	int leftmost; // nil when empty
+	size_t count;
+
+	VruntimeTree(const std::vector<Tick> *keys, const std::vector<int> *ranks, size_t capacity)
+			: vruntime(keys), rank(ranks), left(capacity + 1), right(capacity + 1), parent(capacity + 1), red(capacity + 1, 0),
+				nil(capacity), root(capacity), leftmost(capacity), count(0) {}
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+	int first() const { return leftmost; }
+
+	void insert(int process)
+	{
+		int above = nil, slot = root;
+		bool is_leftmost = true;
+		while (slot != nil)
+		{
+			above = slot;
+			if (less(process, slot))
+				slot = left[slot];
+			else
+			{
+				slot = right[slot];
+				is_leftmost = false;
+			}
+		}
+		parent[process] = above;
+		if (above == nil)
+			root = process;
+		else if (less(process, above))
+			left[above] = process;
+		else
+			right[above] = process;
+		left[process] = right[process] = nil;
+		red[process] = 1;
+		if (is_leftmost)
+			leftmost = process;
+		count++;
+		insertFixup(process);
+	}
+
+	void erase(int process)
+	{
+		if (process == leftmost)
+			leftmost = right[process] != nil ? minimum(right[process]) : parent[process];
+
+		int moved = process, child;
+		bool moved_red = red[moved];
+		if (left[process] == nil)
+		{
+			child = right[process];
+			transplant(process, child);
+		}
+		else if (right[process] == nil)
+		{
+			child = left[process];
+			transplant(process, child);
+		}
+		else
+		{
+			// the successor takes the place of the erased node
+			moved = minimum(right[process]);
+			moved_red = red[moved];
+			child = right[moved];
+			if (parent[moved] == process)
+				parent[child] = moved;
+			else
+			{
+				transplant(moved, right[moved]);
+				right[moved] = right[process];
+				parent[right[moved]] = moved;
+			}
+			transplant(process, moved);
+			left[moved] = left[process];
+			parent[left[moved]] = moved;
+			red[moved] = red[process];
+		}
+		count--;
+		if (!moved_red)
+			eraseFixup(child);
+	}
+
+private:
+	bool less(int p1, int p2) const
+	{
+		if ((*vruntime)[p1] != (*vruntime)[p2])
+			return (*vruntime)[p1] < (*vruntime)[p2];
+		return (*rank)[p1] < (*rank)[p2];
+	}
+
+	int minimum(int node) const
+	{
+		while (left[node] != nil)
+			node = left[node];
+		return node;
+	}
+
+	void transplant(int node, int replacement)
+	{
+		if (parent[node] == nil)
+			root = replacement;
+		else if (node == left[parent[node]])
+			left[parent[node]] = replacement;
+		else
+			right[parent[node]] = replacement;
+		parent[replacement] = parent[node];
+	}
+
+	// rotate(node, left, right) is a left rotation, rotate(node, right, left) a right rotation
+	void rotate(int node, std::vector<int> &down, std::vector<int> &up)
+	{
+		int pivot = up[node];
+		up[node] = down[pivot];
+		if (down[pivot] != nil)
+			parent[down[pivot]] = node;
+		parent[pivot] = parent[node];
+		if (parent[node] == nil)
+			root = pivot;
+		else if (node == left[parent[node]])
+			left[parent[node]] = pivot;
+		else
+			right[parent[node]] = pivot;
+		down[pivot] = node;
+		parent[node] = pivot;
+	}
+
+	void insertFixup(int node)
+	{
+		while (red[parent[node]])
+		{
+			int grandparent = parent[parent[node]];
+			bool on_left = parent[node] == left[grandparent];
+			std::vector<int> &same = on_left ? left : right, &other = on_left ? right : left;
+			int uncle = other[grandparent];
+			if (red[uncle])
+			{
+				red[parent[node]] = red[uncle] = 0;
+				red[grandparent] = 1;
+				node = grandparent;
+				continue;
+			}
+			if (node == other[parent[node]])
+			{
+				node = parent[node];
+				rotate(node, same, other);
+			}
+			red[parent[node]] = 0;
+			red[grandparent] = 1;
+			rotate(grandparent, other, same);
+		}
+		red[root] = 0;
+	}
+
+	void eraseFixup(int node)
+	{
+		while (node != root && !red[node])
+		{
+			bool on_left = node == left[parent[node]];
+			std::vector<int> &same = on_left ? left : right, &other = on_left ? right : left;
+			int sibling = other[parent[node]];
+			if (red[sibling])
+			{
+				red[sibling] = 0;
+				red[parent[node]] = 1;
+				rotate(parent[node], same, other);
+				sibling = other[parent[node]];
+			}
+			if (!red[same[sibling]] && !red[other[sibling]])
+			{
+				red[sibling] = 1;
+				node = parent[node];
+				continue;
+			}
+			if (!red[other[sibling]])
+			{
+				red[same[sibling]] = 0;
+				red[sibling] = 1;
+				rotate(sibling, other, same);
+				sibling = other[parent[node]];
+			}
+			red[sibling] = red[parent[node]];
+			red[parent[node]] = red[other[sibling]] = 0;
+			rotate(parent[node], same, other);
+			node = root;
+		}
+		red[node] = 0;
+	}
+};
+
+// Least loaded core first (queued + running), ties to the lowest core
+struct CompareCoreLoad
+{
+	const std::vector<size_t> *load;
+
+	bool operator()(int c1, int c2) const
+	{
+		if ((*load)[c1] != (*load)[c2])
+			return (*load)[c1] < (*load)[c2];
+		return c1 < c2;
+	}
+};
+
+// Longest run queue first, ties to the lowest core
+struct CompareCoreBacklog
+{
+	const std::vector<size_t> *queued;
+
+	bool operator()(int c1, int c2) const
+	{
+		if ((*queued)[c1] != (*queued)[c2])
+			return (*queued)[c1] > (*queued)[c2];
+		return c1 < c2;
+	}
+};
+
+// Adds result rows [begin, end) to a summary; one version per instruction set
+typedef void (*AggregateKernel)(const Tick *const *columns, const Tick *burst, size_t begin, size_t end, ResultSummary &summary);
+
+/* ------------------------- function defininations ------------------------- */
+void resetProcessState(const Workload &table, ProcessState &state);
+PriorityBuckets createPriorityBuckets(const Workload &table);
+void dispatchProcess(const Workload &table, ProcessState &state, SimulationResult &result, int &last_process, int current, Tick current_time);
+void completeProcess(const Workload &table, ProcessState &state, SimulationResult &result, int current, Tick current_time);
+void aggregateBlocks(AggregateKernel kernel, const Tick *const *columns, const Tick *burst, ResultSummary &summary);
+int niceWeight(int priority);
+SimulationResult simulateFair(const Workload &table, ProcessState &state, Tick min_granularity, Tick latency);
+SimulationResult simulateFeedback(const Workload &table, ProcessState &state, const std::vector<Tick> &quantums, Tick boost_period, FeedbackRun &run);
+
+/**
+ * @brief size the mutable state of a simulation run to a workload and clear it
+ *
+ * The buffers keep their memory, so resetting a state for a workload of the
+ * same size does not allocate.
+ *
+ * @param table workload the run is simulated on
+ * @param state state to reset, remaining time becomes the burst time
+ */
+void resetProcessState(const Workload &table, ProcessState &state)
+{
+	size_t n = table.size();
+	state.remaining_time.assign(table.burst_time.begin(), table.burst_time.end());
+	state.waiting_time.assign(n, 0);
+	state.turnaround_time.assign(n, 0);
+	state.completion_time.assign(n, 0);
+	state.response_time.assign(n, -1);
+	state.completed.assign(n, 0);
+	state.metrics = SchedulerMetrics();
+}
+
+/**
+ * @brief allocate an empty priority ready queue covering every priority of the workload
+ *
+ * @param table workload the queue is built for, its priorities span fewer
+ * than PRIORITY_LEVELS values (see checkConfig)
+ *
+ * @return PriorityBuckets with one bucket per priority value in [min, max]
+ */
+PriorityBuckets createPriorityBuckets(const Workload &table)
+{
+	PriorityBuckets buckets{};
+	int lowest = 0, highest = 0;
+	if (table.size() > 0)
+	{
+		lowest = *std::min_element(table.priority.begin(), table.priority.end());
+		highest = *std::max_element(table.priority.begin(), table.priority.end());
+	}
+
+	buckets.base_priority = lowest;
+	buckets.first.assign(highest - lowest + 1, -1);
+	buckets.last.assign(highest - lowest + 1, -1);
+	buckets.next.assign(table.size(), -1);
+	return buckets;
+}
+
+HighestPriorityFirst::HighestPriorityFirst(const Workload &table, const ProcessState &) : table(&table), queue(createPriorityBuckets(table)) {}
+
+/**
+ * @brief give the CPU to a process: count the context switch and record its first response
+ *
+ * @param table workload being scheduled
+ * @param state per-run state
+ * @param result run totals
+ * @param last_process process that held the CPU before, updated to current
+ * @param current process being dispatched
+ * @param current_time dispatch time
+ */
+void dispatchProcess(const Workload &table, ProcessState &state, SimulationResult &result, int &last_process, int current, Tick current_time)
+{
+	METRIC_ADD(state.metrics.dispatches, 1);
+	if (last_process != -1 && last_process != current)
+	{
+		result.context_switches++;
+		METRIC_ADD(state.metrics.preemptions, !state.completed[last_process]);
+	}
+	last_process = current;
+
+	if (state.response_time[current] < 0)
+	{
+		state.response_time[current] = current_time - table.arrival_time[current];
+		result.total_response_time += state.response_time[current];
+	}
+}
+
+/**
+ * @brief record the completion of a process
+ *
+ * @param table workload being scheduled
+ * @param state per-run state
+ * @param result run totals
+ * @param current completed process
+ * @param current_time completion time
+ */
+void completeProcess(const Workload &table, ProcessState &state, SimulationResult &result, int current, Tick current_time)
+{
+	state.remaining_time[current] = 0;
+	state.completion_time[current] = current_time;
+	state.turnaround_time[current] = current_time - table.arrival_time[current];
+	state.waiting_time[current] = state.turnaround_time[current] - table.burst_time[current];
+	state.completed[current] = true;
+
+	result.total_waiting_time += state.waiting_time[current];
+	result.total_turnaround_time += state.turnaround_time[current];
+}
+
+/* ---------------------------- Result aggregation --------------------------- */
+
+/**
+ * @brief add result rows [begin, end) one at a time (any CPU, also the tail of the vector kernels)
+ *
+ * @param columns waiting, turnaround and response time columns
+ * @param burst burst time column
+ * @param begin first row
+ * @param end one past the last row
+ * @param summary summary being built
+ */
+void aggregateScalar(const Tick *const *columns, const Tick *burst, size_t begin, size_t end, ResultSummary &summary)
+{
+	for (size_t i = begin; i < end; i++)
+		addResult(summary, i, columns[SUMMARY_WAITING][i], columns[SUMMARY_TURNAROUND][i], columns[SUMMARY_RESPONSE][i], burst[i]);
+}
+
+/**
+ * @brief add one finished process to a summary (percentiles excluded)
+ *
+ * @param summary summary being built
+ * @param row position of the process, selects its slowdown lane
+ * @param waiting_time waiting time
+ * @param turnaround_time turnaround time
+ * @param response_time response time
+ * @param burst_time burst time
+ */
+void addResult(ResultSummary &summary, size_t row, Tick waiting_time, Tick turnaround_time, Tick response_time, Tick burst_time)
+{
+	Tick values[SUMMARY_COLUMNS] = {waiting_time, turnaround_time, response_time};
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		summary.total[column] += values[column];
+		summary.minimum[column] = std::min(summary.minimum[column], values[column]);
+		summary.maximum[column] = std::max(summary.maximum[column], values[column]);
+	}
+	double slowdown = (double)turnaround_time / std::max<double>(burst_time, 1.0);
+	summary.slowdown_lanes[row % 4] += slowdown;
+	summary.slowdown_square_lanes[row % 4] += slowdown * slowdown;
+	summary.slowdown_max = std::max(summary.slowdown_max, slowdown);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief exact int64 to double for 0 <= value < 2^52 (AVX2 has no conversion instruction),
+ * the kernels hand rows outside that range to aggregateScalar
+ */
+__attribute__((target("avx2"))) static inline __m256d toDouble(__m256i value)
+{
+	const __m256i exponent = _mm256_set1_epi64x(0x4330000000000000LL); // 2^52
+	return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(value, exponent)), _mm256_set1_pd(0x1p52));
+}
+
+/**
+ * @brief AVX2 kernel: 4 rows per step, int64 min/max through compare and blend
+ *
+ * @param columns waiting, turnaround and response time columns
+ * @param burst burst time column
+ * @param begin first row
+ * @param end one past the last row, at most AGGREGATE_BLOCK after begin
+ * @param summary summary being built
+ */
+__attribute__((target("avx2"))) void aggregateAVX2(const Tick *const *columns, const Tick *burst, size_t begin, size_t end, ResultSummary &summary)
+{
+	__m256i total[SUMMARY_COLUMNS], low[SUMMARY_COLUMNS], high[SUMMARY_COLUMNS];
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		total[column] = _mm256_setzero_si256();
+		low[column] = _mm256_set1_epi64x(summary.minimum[column]);
+		high[column] = _mm256_set1_epi64x(summary.maximum[column]);
+	}
+	__m256d slowdown_total = _mm256_loadu_pd(summary.slowdown_lanes);
+	__m256d slowdown_square_total = _mm256_loadu_pd(summary.slowdown_square_lanes);
+	__m256d slowdown_max = _mm256_set1_pd(summary.slowdown_max);
+	const __m256d one = _mm256_set1_pd(1.0);
+	// every value seen ORed together: bits from 2^52 up mean a value left the exact range
+	__m256i range = _mm256_setzero_si256();
+
+	// begin is a multiple of 4, so vector lane k holds rows i % 4 == k
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		for (int column = 0; column < SUMMARY_COLUMNS; column++)
+		{
+			__m256i value = _mm256_loadu_si256((const __m256i *)(columns[column] + i));
+			total[column] = _mm256_add_epi64(total[column], value);
+			low[column] = _mm256_blendv_epi8(low[column], value, _mm256_cmpgt_epi64(low[column], value));
+			high[column] = _mm256_blendv_epi8(high[column], value, _mm256_cmpgt_epi64(value, high[column]));
+			range = _mm256_or_si256(range, value);
+		}
+		__m256i burst_ticks = _mm256_loadu_si256((const __m256i *)(burst + i));
+		range = _mm256_or_si256(range, burst_ticks);
+		__m256d turnaround = toDouble(_mm256_loadu_si256((const __m256i *)(columns[SUMMARY_TURNAROUND] + i)));
+		__m256d burst_time = _mm256_max_pd(toDouble(burst_ticks), one);
+		__m256d slowdown = _mm256_div_pd(turnaround, burst_time);
+		slowdown_total = _mm256_add_pd(slowdown_total, slowdown);
+		slowdown_square_total = _mm256_add_pd(slowdown_square_total, _mm256_mul_pd(slowdown, slowdown));
+		slowdown_max = _mm256_max_pd(slowdown_max, slowdown);
+	}
+
+	// Negative or huge values: nothing has been added yet, redo the block exactly
+	if (!_mm256_testz_si256(range, _mm256_set1_epi64x(-(1LL << 52))))
+	{
+		aggregateScalar(columns, burst, begin, end, summary);
+		return;
+	}
+
+	alignas(32) Tick lanes[4];
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		_mm256_store_si256((__m256i *)lanes, total[column]);
+		summary.total[column] += (TickTotal)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		_mm256_store_si256((__m256i *)lanes, low[column]);
+		summary.minimum[column] = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+		_mm256_store_si256((__m256i *)lanes, high[column]);
+		summary.maximum[column] = std::max({lanes[0], lanes[1], lanes[2], lanes[3]});
+	}
+	alignas(32) double maximum[4];
+	_mm256_storeu_pd(summary.slowdown_lanes, slowdown_total);
+	_mm256_storeu_pd(summary.slowdown_square_lanes, slowdown_square_total);
+	_mm256_store_pd(maximum, slowdown_max);
+	summary.slowdown_max = std::max({maximum[0], maximum[1], maximum[2], maximum[3]});
+
+	aggregateScalar(columns, burst, i, end, summary);
+}
+
+/**
+ * @brief SSE4.2 kernel: 2 rows per register, two registers per step to keep the 4 lane layout
+ *
+ * @param columns waiting, turnaround and response time columns
+ * @param burst burst time column
+ * @param begin first row
+ * @param end one past the last row, at most AGGREGATE_BLOCK after begin
+ * @param summary summary being built
+ */
+__attribute__((target("sse4.2"))) void aggregateSSE42(const Tick *const *columns, const Tick *burst, size_t begin, size_t end, ResultSummary &summary)
+{
+	__m128i total[SUMMARY_COLUMNS], low[SUMMARY_COLUMNS], high[SUMMARY_COLUMNS];
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		total[column] = _mm_setzero_si128();
+		low[column] = _mm_set1_epi64x(summary.minimum[column]);
+		high[column] = _mm_set1_epi64x(summary.maximum[column]);
+	}
+	__m128d slowdown_total[2] = {_mm_loadu_pd(summary.slowdown_lanes), _mm_loadu_pd(summary.slowdown_lanes + 2)};
+	__m128d slowdown_square_total[2] = {_mm_loadu_pd(summary.slowdown_square_lanes), _mm_loadu_pd(summary.slowdown_square_lanes + 2)};
+	__m128d slowdown_max = _mm_set1_pd(summary.slowdown_max);
+	const __m128i exponent = _mm_set1_epi64x(0x4330000000000000LL); // 2^52, exact int64 to double below it
+	const __m128d exponent_value = _mm_set1_pd(0x1p52), one = _mm_set1_pd(1.0);
+	__m128i range = _mm_setzero_si128(); // every value seen ORed together, see aggregateAVX2
+
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		for (int half = 0; half < 2; half++)
+		{
+			size_t row = i + 2 * half;
+			for (int column = 0; column < SUMMARY_COLUMNS; column++)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(columns[column] + row));
+				total[column] = _mm_add_epi64(total[column], value);
+				low[column] = _mm_blendv_epi8(low[column], value, _mm_cmpgt_epi64(low[column], value));
+				high[column] = _mm_blendv_epi8(high[column], value, _mm_cmpgt_epi64(value, high[column]));
+				range = _mm_or_si128(range, value);
+			}
+			__m128i turnaround_ticks = _mm_loadu_si128((const __m128i *)(columns[SUMMARY_TURNAROUND] + row));
+			__m128i burst_ticks = _mm_loadu_si128((const __m128i *)(burst + row));
+			range = _mm_or_si128(range, burst_ticks);
+			__m128d turnaround = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(turnaround_ticks, exponent)), exponent_value);
+			__m128d burst_time = _mm_max_pd(_mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(burst_ticks, exponent)), exponent_value), one);
+			__m128d slowdown = _mm_div_pd(turnaround, burst_time);
+			slowdown_total[half] = _mm_add_pd(slowdown_total[half], slowdown);
+			slowdown_square_total[half] = _mm_add_pd(slowdown_square_total[half], _mm_mul_pd(slowdown, slowdown));
+			slowdown_max = _mm_max_pd(slowdown_max, slowdown);
+		}
+	}
+
+	if (!_mm_testz_si128(range, _mm_set1_epi64x(-(1LL << 52))))
+	{
+		aggregateScalar(columns, burst, begin, end, summary);
+		return;
+	}
+
+	alignas(16) Tick lanes[2];
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		_mm_store_si128((__m128i *)lanes, total[column]);
+		summary.total[column] += (TickTotal)lanes[0] + lanes[1];
+		_mm_store_si128((__m128i *)lanes, low[column]);
+		summary.minimum[column] = std::min(lanes[0], lanes[1]);
+		_mm_store_si128((__m128i *)lanes, high[column]);
+		summary.maximum[column] = std::max(lanes[0], lanes[1]);
+	}
+	alignas(16) double maximum[2];
+	_mm_storeu_pd(summary.slowdown_lanes, slowdown_total[0]);
+	_mm_storeu_pd(summary.slowdown_lanes + 2, slowdown_total[1]);
+	_mm_storeu_pd(summary.slowdown_square_lanes, slowdown_square_total[0]);
+	_mm_storeu_pd(summary.slowdown_square_lanes + 2, slowdown_square_total[1]);
+	_mm_store_pd(maximum, slowdown_max);
+	summary.slowdown_max = std::max(maximum[0], maximum[1]);
+
+	aggregateScalar(columns, burst, i, end, summary);
+}
+#endif
+
+/**
+ * @brief pick the widest aggregation kernel the CPU supports
+ *
+ * @return AggregateKernel
+ */
+AggregateKernel selectAggregateKernel()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return aggregateAVX2;
+	if (__builtin_cpu_supports("sse4.2"))
+		return aggregateSSE42;
+#endif
+	return aggregateScalar;
+}
+
+/**
+ * @brief feed every result row to a kernel, AGGREGATE_BLOCK rows at a time
+ *
+ * @param kernel aggregation kernel
+ * @param columns waiting, turnaround and response time columns
+ * @param burst burst time column
+ * @param summary summary being built, its count is the number of rows
+ */
+void aggregateBlocks(AggregateKernel kernel, const Tick *const *columns, const Tick *burst, ResultSummary &summary)
+{
+	for (size_t begin = 0; begin < summary.count; begin += AGGREGATE_BLOCK)
+		kernel(columns, burst, begin, std::min(summary.count, begin + AGGREGATE_BLOCK), summary);
+}
+
+/**
+ * @brief summary statistics of a finished run in one pass over its result columns
+ *
+ * Rows are fed to the kernel in blocks of AGGREGATE_BLOCK, which keeps the
+ * int64 lane sums from overflowing before they are added to the exact
+ * totals. Slowdowns are summed per lane in row order by every kernel, so
+ * the result doesn't depend on the instruction set. The vector kernels
+ * hand blocks with a time outside [0, 2^52) ticks to aggregateScalar, which
+ * keeps their lane sums and int64 to double conversions exact.
+ *
+ * @param state state of a finished run
+ * @param table workload the run used
+ *
+ * @return ResultSummary
+ */
+ResultSummary aggregateResults(const ProcessState &state, const Workload &table)
+{
+	// chosen once, on the first call from any thread
+	static const AggregateKernel kernel = selectAggregateKernel();
+	ResultSummary summary = createResultSummary();
+	summary.count = table.size();
+
+	const Tick *columns[SUMMARY_COLUMNS] = {state.waiting_time.data(), state.turnaround_time.data(), state.response_time.data()};
+	aggregateBlocks(kernel, columns, table.burst_time.begin(), summary);
+
+	// Percentiles: large runs fill one histogram set per worker, merged afterwards
+	size_t workers = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), summary.count / HISTOGRAM_PARALLEL_ROWS));
+	std::vector<std::vector<LatencyHistogram>> partial(workers, std::vector<LatencyHistogram>(SUMMARY_COLUMNS));
+	runParallel(workers, workers, [&](size_t worker)
+							{
+		size_t first = summary.count * worker / workers, last = summary.count * (worker + 1) / workers;
+		for (int column = 0; column < SUMMARY_COLUMNS; column++)
+			for (size_t i = first; i < last; i++)
+				partial[worker][column].record(columns[column][i]); });
+	for (size_t worker = 0; worker < workers; worker++)
+		for (int column = 0; column < SUMMARY_COLUMNS; column++)
+			summary.latency[column].merge(partial[worker][column]);
+
+	finishSummary(summary);
+	return summary;
+}
+
+#ifdef BENCHMARK
+/**
+ * @brief run a finished state through every aggregation kernel the CPU supports and compare them with the scalar one
+ *
+ * @param state state of a finished run
+ * @param table workload the run used
+ *
+ * @return std::string name of the first kernel whose summary differs, empty when they all agree
+ */
+std::string checkAggregateKernels(const ProcessState &state, const Workload &table)
+{
+	std::vector<std::pair<std::string, AggregateKernel>> kernels;
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		kernels.push_back({"AVX2", aggregateAVX2});
+	if (__builtin_cpu_supports("sse4.2"))
+		kernels.push_back({"SSE4.2", aggregateSSE42});
+#endif
+
+	const Tick *columns[SUMMARY_COLUMNS] = {state.waiting_time.data(), state.turnaround_time.data(), state.response_time.data()};
+	ResultSummary expected = createResultSummary();
+	expected.count = table.size();
+	aggregateBlocks(aggregateScalar, columns, table.burst_time.begin(), expected);
+
+	for (auto &kernel : kernels)
+	{
+		ResultSummary summary = createResultSummary();
+		summary.count = table.size();
+		aggregateBlocks(kernel.second, columns, table.burst_time.begin(), summary);
+		if (!std::equal(summary.total, summary.total + SUMMARY_COLUMNS, expected.total) ||
+				!std::equal(summary.minimum, summary.minimum + SUMMARY_COLUMNS, expected.minimum) ||
+				!std::equal(summary.maximum, summary.maximum + SUMMARY_COLUMNS, expected.maximum) ||
+				!std::equal(summary.slowdown_lanes, summary.slowdown_lanes + 4, expected.slowdown_lanes) ||
+				!std::equal(summary.slowdown_square_lanes, summary.slowdown_square_lanes + 4, expected.slowdown_square_lanes) ||
+				summary.slowdown_max != expected.slowdown_max)
+			return kernel.first;
+	}
+	return "";
+}
+#endif
+
+/**
+ * @brief empty summary, ready for addResult or the aggregation kernels
+ *
+ * @return ResultSummary
+ */
+ResultSummary createResultSummary()
+{
+	ResultSummary summary{};
+	for (int column = 0; column < SUMMARY_COLUMNS; column++)
+	{
+		summary.minimum[column] = INT64_MAX;
+		summary.maximum[column] = INT64_MIN;
+	}
+	return summary;
+}
+
+/**
+ * @brief combine the slowdown lanes once every process has been added
+ *
+ * @param summary summary being built
+ */
+void finishSummary(ResultSummary &summary)
+{
+	summary.slowdown_total = (summary.slowdown_lanes[0] + summary.slowdown_lanes[1]) + (summary.slowdown_lanes[2] + summary.slowdown_lanes[3]);
+	summary.slowdown_square_total = (summary.slowdown_square_lanes[0] + summary.slowdown_square_lanes[1]) +
+																	(summary.slowdown_square_lanes[2] + summary.slowdown_square_lanes[3]);
+}
+
+/**
+ * @brief run independent tasks on a pool of worker threads
+ *
+ * Workers claim task numbers through an atomic counter; the calling thread
+ * works too. Tasks must only write to their own slots of caller-owned
+ * buffers.
+ *
+ * @param task_count number of tasks
+ * @param thread_count number of worker threads (0 = one per core)
+ * @param task called once with every task number in [0, task_count)
+ */
+void runParallel(size_t task_count, unsigned thread_count, const std::function<void(size_t)> &task)
+{
+	std::atomic<size_t> next_task(0);
+
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	thread_count = std::min<size_t>(thread_count, task_count);
+
+	auto worker = [&]()
+	{
+		for (size_t current; (current = next_task++) < task_count;)
+			task(current);
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned i = 1; i < thread_count; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (std::thread &thread : pool)
+		thread.join();
+}
+
+/**
+ * @brief single CPU scheduling, one instantiation per algorithm
+ *
+ * Processes are admitted in arrival order and idle gaps jump straight to
+ * the next arrival. The head of the ready queue runs for the slice the
+ * quantum policy gives it; with arrival preemption it stops at every
+ * arrival inside the slice and gives the CPU away when the preemption
+ * policy says so. Arrivals during a slice enter the queue before the
+ * process that used it. The policies are resolved at compile time, so
+ * every instantiation is as tight as a hand written loop:
+ *
+ *   FCFS         ArrivalOrder,           NonPreemptive,    RunToCompletion
+ *   SJF-NP       ShortestBurstFirst,     NonPreemptive,    RunToCompletion
+ *   SJF-P        ShortestRemainingFirst, PreemptOnArrival, RunToCompletion
+ *   Priority-NP  HighestPriorityFirst,   NonPreemptive,    RunToCompletion
+ *   Priority-P   HighestPriorityFirst,   PreemptOnArrival, RunToCompletion
+ *   RR           ArrivalOrder,           NonPreemptive,    FixedQuantum
+ *
+ * @param table workload to schedule
+ * @param state per-run state, filled with the schedule
+ * @param quantum quantum policy
+ *
+ * @return SimulationResult run totals
+ */
+template <class ReadyQueue, class Preemption, class Quantum>
+SimulationResult simulateSchedule(const Workload &table, ProcessState &state, Quantum quantum = Quantum())
+{
+	std::vector<int> &order = state.order;
+	{
+		METRIC_PHASE(sort_timer, state.metrics.sort_seconds);
+		sortProcesses(table, SORT_BY_ARRIVAL, order);
+	}
+
+	ReadyQueue ready(table, state);
+	SimulationResult result{0, 0, 0, 0};
+
+	Tick current_time = 0;
+	size_t next_arrival = 0;
+	int last_process = -1;
+
+	// Admit every process that has arrived by the given time
+	auto admit = [&](Tick time)
+	{
+		for (; next_arrival < order.size() && table.arrival_time[order[next_arrival]] <= time; next_arrival++)
+		{
+			ready.push(order[next_arrival]);
+			METRIC_ADD(state.metrics.queue_operations, 1);
+		}
+		METRIC_MAX(state.metrics.peak_ready, ready.size());
+	};
+
+	while (next_arrival < order.size() || !ready.empty())
+	{
+		// CPU is idle: fast-forward to the next arrival
+		if (ready.empty() && current_time < table.arrival_time[order[next_arrival]])
+		{
+			METRIC_ADD(state.metrics.idle_time, table.arrival_time[order[next_arrival]] - current_time);
+			current_time = table.arrival_time[order[next_arrival]];
+		}
+		admit(current_time);
+
+		int current = ready.pop();
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		dispatchProcess(table, state, result, last_process, current, current_time);
+
+		Tick remaining = state.remaining_time[current];
+		Tick next_arrival_in = next_arrival < order.size() ? table.arrival_time[order[next_arrival]] - current_time : remaining;
+		Tick finish_time = current_time + quantum.slice(remaining, next_arrival_in, ready.empty());
+		bool preempted = false;
+
+		// Run up to each arrival in the slice and let the preemption policy decide who gets the CPU
+		while (Preemption::on_arrival && !preempted && next_arrival < order.size() && table.arrival_time[order[next_arrival]] < finish_time)
+		{
+			Tick next_time = table.arrival_time[order[next_arrival]];
+			state.remaining_time[current] -= next_time - current_time;
+			current_time = next_time;
+			admit(current_time);
+			preempted = Preemption::preempts(ready, current);
+		}
+
+		if (!preempted)
+		{
+			state.remaining_time[current] -= finish_time - current_time;
+			current_time = finish_time;
+			admit(current_time);
+		}
+
+		if (state.remaining_time[current] > 0)
+		{
+			if (preempted)
+				ready.requeue(current);
+			else
+				ready.push(current);
+			METRIC_ADD(state.metrics.queue_operations, 1);
+			continue;
+		}
+
+		completeProcess(table, state, result, current, current_time);
+	}
+
+	METRIC_SET(state.metrics.makespan, current_time);
+	return result;
+}
+
+/**
+ * @brief fair scheduler weight of a priority: priority p weighs like nice -p
+ * (clamped to nice -20 .. 19), every step is worth about 25% CPU time
+ *
+ * @param priority process priority, higher runs first
+ *
+ * @return int weight, NICE_0_WEIGHT for priority 0
+ */
+int niceWeight(int priority)
+{
+	static const int weights[40] = {
+			/* -20 */ 88761, 71755, 56483, 46273, 36291,
+			/* -15 */ 29154, 23254, 18705, 14949, 11916,
+			/* -10 */ 9548, 7620, 6100, 4904, 3906,
+			/*  -5 */ 3121, 2501, 1991, 1586, 1277,
+			/*   0 */ 1024, 820, 655, 526, 423,
+			/*   5 */ 335, 272, 215, 172, 137,
+			/*  10 */ 110, 87, 70, 56, 45,
+			/*  15 */ 36, 29, 23, 18, 15};
+	int nice = std::max(-20, std::min(19, -priority));
+	return weights[nice + 20];
+}
+
+/**
+ * @brief completely fair scheduling: the process with the least virtual runtime runs next
+ *
+ * Runnable processes sit in a red-black tree keyed on virtual runtime, the
+ * CPU time they received divided by their weight. The leftmost process runs
+ * for its weighted share of the scheduling period (latency,
+ * or min_granularity per process when more are runnable), but never less
+ * than min_granularity, and goes back into the tree. An arrival starts at
+ * the smallest virtual runtime in the run queue, so it neither starves nor
+ * catches up on time it wasn't there for. A process alone on the CPU runs
+ * whole slices up to the next arrival in one step.
+ *
+ * @param table workload to schedule
+ * @param state per-run state, filled with the schedule
+ * @param min_granularity shortest slice in ticks
+ * @param latency scheduling period in ticks while few processes are runnable
+ *
+ * @return SimulationResult run totals
+ */
+SimulationResult simulateFair(const Workload &table, ProcessState &state, Tick min_granularity, Tick latency)
+{
+	std::vector<int> &order = state.order;
+	{
+		METRIC_PHASE(sort_timer, state.metrics.sort_seconds);
+		sortProcesses(table, SORT_BY_ARRIVAL, order);
+	}
+
+	size_t n = table.size();
+	std::vector<Tick> vruntime(n, 0);
+	std::vector<int> rank(n);
+	for (size_t i = 0; i < n; i++)
+		rank[order[i]] = i;
+	VruntimeTree ready(&vruntime, &rank, n);
+	SimulationResult result{0, 0, 0, 0};
+
+	Tick current_time = 0, min_vruntime = 0;
+	long long total_weight = 0; // runnable processes, the running one included
+	size_t next_arrival = 0;
+	int last_process = -1;
+
+	// Admit every process that has arrived by now
+	auto admitArrivals = [&]()
+	{
+		for (; next_arrival < n && table.arrival_time[order[next_arrival]] <= current_time; next_arrival++)
+		{
+			int process = order[next_arrival];
+			vruntime[process] = min_vruntime;
+			ready.insert(process);
+			total_weight += niceWeight(table.priority[process]);
+			METRIC_ADD(state.metrics.queue_operations, 1);
+		}
+		METRIC_MAX(state.metrics.peak_ready, ready.size());
+	};
+
+	while (next_arrival < n || !ready.empty())
+	{
+		// CPU is idle: fast-forward to the next arrival
+		if (ready.empty() && current_time < table.arrival_time[order[next_arrival]])
+		{
+			METRIC_ADD(state.metrics.idle_time, table.arrival_time[order[next_arrival]] - current_time);
+			current_time = table.arrival_time[order[next_arrival]];
+		}
+		admitArrivals();
+
+		int current = ready.first();
+		ready.erase(current);
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		dispatchProcess(table, state, result, last_process, current, current_time);
+
+		int weight = niceWeight(table.priority[current]);
+		Tick period = std::max<Tick>(latency, (Tick)(ready.size() + 1) * min_granularity);
+		Tick slice = std::max<Tick>((TickTotal)period * weight / total_weight, min_granularity);
+		if (ready.empty())
+		{
+			// Alone on the CPU: run whole slices up to the first boundary at or after the next arrival
+			Tick quanta = next_arrival < n ? (table.arrival_time[order[next_arrival]] - current_time + slice - 1) / slice : 1;
+			slice = next_arrival < n ? std::max<Tick>(quanta, 1) * slice : state.remaining_time[current];
+		}
+		slice = std::min(slice, state.remaining_time[current]);
+
+		current_time += slice;
+		state.remaining_time[current] -= slice;
+		vruntime[current] += (TickTotal)slice * NICE_0_WEIGHT / weight;
+
+		// min_vruntime only moves forward, arrivals during the slice start from there
+		bool runnable = state.remaining_time[current] > 0;
+		if (runnable || !ready.empty())
+		{
+			Tick smallest = runnable ? vruntime[current] : INT64_MAX;
+			if (!ready.empty())
+				smallest = std::min(smallest, vruntime[ready.first()]);
+			min_vruntime = std::max(min_vruntime, smallest);
+		}
+		admitArrivals();
+
+		if (runnable)
+		{
+			ready.insert(current);
+			METRIC_ADD(state.metrics.queue_operations, 1);
+			continue;
+		}
+
+		total_weight -= weight;
+		completeProcess(table, state, result, current, current_time);
+	}
+
+	METRIC_SET(state.metrics.makespan, current_time);
+	return result;
+}
+
+/**
+ * @brief multilevel feedback queue: a process drops one level every time it uses up its quantum
+ *
+ * The levels are the buckets of a PriorityBuckets queue (level l is bucket
+ * bottom - l), so the highest non-empty level comes from its bitmap in
+ * O(1). New processes enter the top level and preempt a process running on
+ * a lower one, which keeps the part of its quantum it used and returns to
+ * the head of its level. Every boost_period all processes go back to the
+ * top level: the level lists are spliced together and each process drops
+ * its level and used quantum the next time it is scheduled. A boost takes
+ * effect at the first scheduling decision after it is due. A process alone
+ * on the bottom level runs whole quanta up to the next boost or arrival in
+ * one step.
+ *
+ * @param table workload to schedule
+ * @param state per-run state, filled with the schedule
+ * @param quantums quantum of every level in ticks, top level first
+ * @param boost_period ticks between boosts, 0 for none
+ * @param run level statistics
+ *
+ * @return SimulationResult run totals
+ */
+SimulationResult simulateFeedback(const Workload &table, ProcessState &state, const std::vector<Tick> &quantums, Tick boost_period, FeedbackRun &run)
+{
+	std::vector<int> &order = state.order;
+	{
+		METRIC_PHASE(sort_timer, state.metrics.sort_seconds);
+		sortProcesses(table, SORT_BY_ARRIVAL, order);
+	}
+
+	size_t n = table.size();
+	int bottom = quantums.size() - 1;
+	PriorityBuckets ready{};
+	ready.base_priority = 0;
+	ready.first.assign(bottom + 1, -1);
+	ready.last.assign(bottom + 1, -1);
+	ready.next.assign(n, -1);
+	std::vector<int> level(n, 0);
+	std::vector<Tick> used(n, 0);					// part of the current level's quantum already used
+	std::vector<long long> boost_seen(n, 0); // run.boosts when level and used were last valid
+
+	run.demotions = run.boosts = 0;
+	run.completed.assign(bottom + 1, 0);
+	SimulationResult result{0, 0, 0, 0};
+	Tick current_time = 0, next_boost = boost_period > 0 ? boost_period : INT64_MAX;
+	size_t next_arrival = 0;
+	int last_process = -1;
+
+	auto boostIfDue = [&]()
+	{
+		if (current_time < next_boost)
+			return;
+		ready.mergeInto(bottom);
+		run.boosts++;
+		next_boost = (current_time / boost_period + 1) * boost_period;
+	};
+
+	// Admit every process that has arrived by now, on the top level
+	auto admitArrivals = [&]()
+	{
+		for (; next_arrival < n && table.arrival_time[order[next_arrival]] <= current_time; next_arrival++)
+		{
+			int process = order[next_arrival];
+			boost_seen[process] = run.boosts;
+			ready.pushBack(process, bottom);
+			METRIC_ADD(state.metrics.queue_operations, 1);
+		}
+		METRIC_MAX(state.metrics.peak_ready, ready.size());
+	};
+
+	auto applyBoost = [&](int process)
+	{
+		if (boost_seen[process] == run.boosts)
+			return;
+		boost_seen[process] = run.boosts;
+		level[process] = 0;
+		used[process] = 0;
+	};
+
+	while (next_arrival < n || !ready.empty())
+	{
+		// CPU is idle: fast-forward to the next arrival
+		if (ready.empty() && current_time < table.arrival_time[order[next_arrival]])
+		{
+			METRIC_ADD(state.metrics.idle_time, table.arrival_time[order[next_arrival]] - current_time);
+			current_time = table.arrival_time[order[next_arrival]];
+		}
+		boostIfDue();
+		admitArrivals();
+
+		int current = ready.pop();
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		applyBoost(current);
+		dispatchProcess(table, state, result, last_process, current, current_time);
+
+		Tick quantum = quantums[level[current]];
+		Tick slice = std::min(quantum - used[current], state.remaining_time[current]);
+		bool preemptible = level[current] > 0; // arrivals enter above it
+		if (ready.empty() && level[current] == bottom)
+		{
+			// Alone on the bottom level, where a used up quantum changes nothing: run whole
+			// quanta up to the first boundary at or after the next boost or non-preempting arrival
+			Tick horizon = next_boost;
+			if (!preemptible && next_arrival < n)
+				horizon = std::min(horizon, table.arrival_time[order[next_arrival]]);
+			if (horizon == INT64_MAX)
+				slice = state.remaining_time[current];
+			else if (horizon > current_time + slice)
+				slice += (horizon - current_time - slice + quantum - 1) / quantum * quantum;
+			slice = std::min(slice, state.remaining_time[current]);
+		}
+		if (preemptible && next_arrival < n && table.arrival_time[order[next_arrival]] < current_time + slice)
+			slice = table.arrival_time[order[next_arrival]] - current_time;
+
+		current_time += slice;
+		state.remaining_time[current] -= slice;
+		used[current] += slice;
+		boostIfDue();
+		admitArrivals();
+
+		if (state.remaining_time[current] == 0)
+		{
+			run.completed[level[current]]++;
+			completeProcess(table, state, result, current, current_time);
+			continue;
+		}
+
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		if (boost_seen[current] != run.boosts)
+		{
+			// Boosted while it ran: back to the top level
+			applyBoost(current);
+			ready.pushBack(current, bottom);
+		}
+		else if (used[current] % quantum == 0)
+		{
+			// Used up its quantum: one level down
+			if (level[current] < bottom)
+			{
+				level[current]++;
+				run.demotions++;
+			}
+			used[current] = 0;
+			ready.pushBack(current, bottom - level[current]);
+		}
+		else
+		{
+			// Preempted by an arrival
+			used[current] %= quantum;
+			ready.pushFront(current, bottom - level[current]);
+		}
+	}
+
+	METRIC_SET(state.metrics.makespan, current_time);
+	return result;
+}
+
+/**
+ * @brief non-preemptive or round robin scheduling on several CPUs
+ *
+ * Only the end of a slice or an arrival can change the schedule, so the
+ * engine keeps these events on a timing wheel, with only the next arrival
+ * pending at a time, and visits a core only when its own slice is over.
+ * Arrivals go to the least loaded core (or the shared queue), a process out
+ * of quantum goes back to the core it ran on, and an idle core with an
+ * empty queue steals the best process of the longest queue. With private queues and no stealing the cores only meet at
+ * arrivals, so a core runs its slices up to the next arrival on its own.
+ * With one CPU the schedule is the one of the single CPU engines.
+ *
+ * @param table workload to schedule
+ * @param state per-run state, filled with the schedule
+ * @param smp core count and run queue layout
+ * @param TQ time quantum in ticks, 0 to run every process to completion
+ * @param empty_queue run queue every core (or the shared queue) starts as
+ * @param run per-core statistics
+ *
+ * @return SimulationResult run totals
+ */
+template <class ReadyQueue>
+SimulationResult simulateMultiCore(const Workload &table, ProcessState &state, const smp_options &smp, Tick TQ, const ReadyQueue &empty_queue, MultiCoreRun &run)
+{
+	std::vector<int> &order = state.order;
+	{
+		METRIC_PHASE(sort_timer, state.metrics.sort_seconds);
+		sortProcesses(table, SORT_BY_ARRIVAL, order);
+	}
+
+	int core_count = smp.cpus;
+	bool independent = !smp.global_queue && (!smp.steal || core_count == 1);
+	std::vector<ReadyQueue> queues(smp.global_queue ? 1 : core_count, empty_queue);
+
+	// Per-core load (queued + running) for placement and queue length for stealing
+	std::vector<size_t> load(core_count, 0), queued(core_count, 0);
+	IndexedHeap<CompareCoreLoad> least_loaded(CompareCoreLoad{&load}, core_count);
+	IndexedHeap<CompareCoreBacklog> longest_queue(CompareCoreBacklog{&queued}, core_count);
+	// Idle cores and cores with queued work, one bit per core
+	std::vector<uint64_t> idle((core_count + 63) / 64, 0), backlog(idle.size(), 0);
+	for (int core = 0; core < core_count; core++)
+	{
+		least_loaded.push(core);
+		longest_queue.push(core);
+		idle[core / 64] |= 1ULL << (core % 64);
+	}
+
+	std::vector<int> current(core_count, -1), last_process(core_count, -1), last_core(table.size(), -1);
+	// Slice end of every core plus the next arrival, which is event core_count
+	TimingWheel events(core_count + 1);
+	int arrival_event = core_count;
+	std::vector<uint64_t> ending(idle.size(), 0); // cores whose slice ends at the current time
+	std::vector<std::pair<int, int>> expired; // (process, core) out of quantum at the current time
+	run.cores.assign(core_count, CoreStats{0, 0, 0, 0});
+	run.migrations = 0;
+	run.makespan = 0;
+	SimulationResult result{0, 0, 0, 0};
+	size_t next_arrival = 0, total_queued = 0;
+
+	auto nextArrivalTime = [&]()
+	{
+		return next_arrival < order.size() ? table.arrival_time[order[next_arrival]] : INT64_MAX;
+	};
+
+	auto enqueue = [&](int process, int core)
+	{
+		total_queued++;
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		if (smp.global_queue)
+		{
+			queues[0].push(process);
+			return;
+		}
+		queues[core].push(process);
+		load[core]++;
+		queued[core]++;
+		least_loaded.update(core);
+		longest_queue.update(core);
+		backlog[core / 64] |= 1ULL << (core % 64);
+	};
+
+	auto dequeue = [&](int core)
+	{
+		total_queued--;
+		METRIC_ADD(state.metrics.queue_operations, 1);
+		if (smp.global_queue)
+			return queues[0].pop();
+		int process = queues[core].pop();
+		load[core]--;
+		queued[core]--;
+		least_loaded.update(core);
+		longest_queue.update(core);
+		if (queues[core].empty())
+			backlog[core / 64] &= ~(1ULL << (core % 64));
+		return process;
+	};
+
+	auto setRunning = [&](int core, int process)
+	{
+		current[core] = process;
+		if (process == -1)
+			idle[core / 64] |= 1ULL << (core % 64);
+		else
+			idle[core / 64] &= ~(1ULL << (core % 64));
+		if (!smp.global_queue)
+		{
+			load[core] = queued[core] + (process != -1);
+			least_loaded.update(core);
+		}
+	};
+
+	// The slice of a core is over: returns its process if it still needs the CPU
+	auto endSlice = [&](int core, Tick now)
+	{
+		int process = current[core];
+		setRunning(core, -1);
+		if (state.remaining_time[process] > 0)
+			return process;
+		completeProcess(table, state, result, process, now);
+		run.cores[core].completed++;
+		run.makespan = std::max(run.makespan, now);
+		return -1;
+	};
+
+	// Give an idle core the next process of a queue; independent cores keep
+	// going with their own queue up to the next arrival
+	auto startSlice = [&](int core, int source, Tick now)
+	{
+		for (;;)
+		{
+			int process = dequeue(source);
+			if (source != core && !smp.global_queue)
+				run.cores[core].steals++;
+			dispatchProcess(table, state, result, last_process[core], process, now);
+			if (last_core[process] != -1 && last_core[process] != core)
+				run.migrations++;
+			last_core[process] = core;
+
+			Tick slice = TQ > 0 ? std::min(TQ, state.remaining_time[process]) : state.remaining_time[process];
+			state.remaining_time[process] -= slice;
+			run.cores[core].busy_time += slice;
+			run.cores[core].dispatches++;
+			setRunning(core, process);
+			now += slice;
+
+			if (!independent || now >= nextArrivalTime())
+			{
+				events.insert(core, now);
+				return;
+			}
+			int unfinished = endSlice(core, now);
+			if (unfinished != -1)
+				enqueue(unfinished, core);
+			if (queues[core].empty())
+				return;
+			source = core;
+		}
+	};
+
+	if (!order.empty())
+		events.insert(arrival_event, nextArrivalTime());
+
+	while (!events.empty())
+	{
+		// Take out every event due at the next event time
+		bool arrivals = false;
+		Tick now;
+		do
+		{
+			int event = events.pop();
+			now = events.now;
+			if (event == arrival_event)
+				arrivals = true;
+			else
+				ending[event / 64] |= 1ULL << (event % 64);
+		} while (events.dueNow());
+
+		// Slices ending now in core order, then arrivals, then the processes out of quantum (as on one CPU)
+		for (size_t word = 0; word < ending.size(); word++)
+			for (; ending[word] != 0; ending[word] &= ending[word] - 1)
+			{
+				int core = word * 64 + __builtin_ctzll(ending[word]);
+				int unfinished = endSlice(core, now);
+				if (unfinished != -1)
+					expired.push_back({unfinished, core});
+			}
+		if (arrivals)
+		{
+			for (; next_arrival < order.size() && table.arrival_time[order[next_arrival]] <= now; next_arrival++)
+				enqueue(order[next_arrival], smp.global_queue ? 0 : least_loaded.top());
+			if (next_arrival < order.size())
+				events.insert(arrival_event, nextArrivalTime());
+		}
+		for (const std::pair<int, int> &slice : expired)
+			enqueue(slice.first, slice.second);
+		expired.clear();
+		METRIC_MAX(state.metrics.peak_ready, total_queued);
+
+		// Hand queued work to the idle cores, lowest core first: first the cores
+		// with work of their own, then the shared queue or stealing for the rest
+		for (int pass = 0; pass < 2; pass++)
+			for (size_t word = 0; word < idle.size() && total_queued > 0; word++)
+			{
+				uint64_t candidates = pass == 0 ? idle[word] & backlog[word] : independent ? 0 : idle[word];
+				while (candidates != 0 && total_queued > 0)
+				{
+					int core = word * 64 + __builtin_ctzll(candidates);
+					candidates &= candidates - 1;
+					// a stolen process comes from the longest queue, it has work since total_queued > 0
+					int source = smp.global_queue ? 0 : pass == 0 ? core : longest_queue.top();
+					startSlice(core, source, now);
+				}
+			}
+	}
+
+	Tick busy_time = 0;
+	for (const CoreStats &core : run.cores)
+		busy_time += core.busy_time;
+	// idle time of the average core, so utilization in the metrics is the mean over the cores
+	METRIC_ADD(state.metrics.idle_time, ((Tick)core_count * run.makespan - busy_time) / core_count);
+	METRIC_SET(state.metrics.makespan, run.makespan);
+	return result;
+}
+
+/**
+ * @brief order the workload without touching it, in O(N log N)
+ * @param table workload table
+ * @param key primary sort key, ties fall back to arrival, priority then pid
+ * @param order output buffer, reused across calls (only grows)
+ * @return void
+ */
+void sortProcesses(const Workload &table, SortKey key, std::vector<int> &order)
+{
+	order.resize(table.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	switch (key)
+	{
+	case SORT_BY_ARRIVAL:
+		std::sort(order.begin(), order.end(), CompareByArrival{&table});
+		break;
+	case SORT_BY_PRIORITY:
+		std::sort(order.begin(), order.end(), CompareByPriority{&table});
+		break;
+	case SORT_BY_BURST:
+		std::sort(order.begin(), order.end(), CompareByBurst{&table});
+		break;
+	}
+}
+
+/**
+ * @brief configuration of an algorithm with the default settings at a time resolution
+ *
+ * @param algorithm scheduling method
+ * @param ticks_per_ms time resolution of the workload
+ *
+ * @return SchedulerConfig on one CPU; the round robin quantum and the feedback
+ * queue levels have no default and are left empty
+ */
+SchedulerConfig createSchedulerConfig(Algorithm algorithm, Tick ticks_per_ms)
+{
+	SchedulerConfig config;
+	config.algorithm = algorithm;
+	config.quantum = 0;
+	config.min_granularity = std::llround(DEFAULT_MIN_GRANULARITY_MS * ticks_per_ms);
+	config.target_latency = (Tick)CFS_TARGET_LATENCY_MS * ticks_per_ms;
+	config.boost_period = 0;
+	config.smp = smp_options{0, false, true};
+	return config;
+}
+
+/**
+ * @brief tell whether a configuration can be simulated on a workload
+ *
+ * @param workload workload to schedule
+ * @param config scheduling method and settings
+ *
+ * @return std::string empty if simulate accepts them, else the reason it doesn't
+ */
+std::string checkConfig(const Workload &workload, const SchedulerConfig &config)
+{
+	bool multi_core_algorithm = config.algorithm == ALGORITHM_FCFS || config.algorithm == ALGORITHM_SJF ||
+															config.algorithm == ALGORITHM_PRIORITY || config.algorithm == ALGORITHM_ROUND_ROBIN;
+	if (config.smp.cpus > MAX_CPUS)
+		return "at most " + std::to_string(MAX_CPUS) + " CPUs are supported";
+	if (config.smp.cpus > 0 && !multi_core_algorithm)
+		return "only fcfs, sjf, prio and rr run on several CPUs";
+	if (config.algorithm == ALGORITHM_ROUND_ROBIN && config.quantum < 1)
+		return "time quantum must be at least one tick";
+	if (config.algorithm == ALGORITHM_FAIR && config.min_granularity < 1)
+		return "minimum granularity must be at least one tick";
+	if (config.algorithm == ALGORITHM_FAIR && config.target_latency < 0)
+		return "target latency must not be negative";
+	if (config.algorithm == ALGORITHM_FEEDBACK)
+	{
+		if (config.mlfq_quantums.empty() || config.mlfq_quantums.size() > MLFQ_MAX_LEVELS)
+			return "the feedback queue needs 1 to " + std::to_string(MLFQ_MAX_LEVELS) + " levels";
+		for (Tick quantum : config.mlfq_quantums)
+			if (quantum < 1)
+				return "feedback queue quanta must be at least one tick";
+		if (config.boost_period < 0)
+			return "boost period must not be negative";
+	}
+
+	// One CPU priority scheduling keeps a bucket per priority value
+	if (config.smp.cpus == 0 && (config.algorithm == ALGORITHM_PRIORITY || config.algorithm == ALGORITHM_PRIORITY_PREEMPTIVE) &&
+			workload.size() > 0)
+	{
+		int lowest = *std::min_element(workload.priority.begin(), workload.priority.end());
+		int highest = *std::max_element(workload.priority.begin(), workload.priority.end());
+		if ((long long)highest - lowest >= PRIORITY_LEVELS)
+			return "priorities must span fewer than " + std::to_string(PRIORITY_LEVELS) + " values (found " +
+						 std::to_string(lowest) + " to " + std::to_string(highest) + ")";
+	}
+	return "";
+}
+
+/**
+ * @brief simulate one scheduling method on a workload
+ *
+ * The workload is only read and nothing outside result is written, so
+ * runs on different results may go on at the same time from any number
+ * of threads.
+ *
+ * @param workload workload to schedule
+ * @param config scheduling method and settings
+ * @param result filled with the schedule, its buffers are reused
+ *
+ * @return bool false, with result untouched, if checkConfig rejects the configuration
+ */
+bool simulate(const Workload &workload, const SchedulerConfig &config, Result &result)
+{
+	if (!checkConfig(workload, config).empty())
+		return false;
+
+	ProcessState &state = result.state;
+	resetProcessState(workload, state);
+
+	if (config.smp.cpus > 0)
+	{
+		size_t capacity = config.smp.global_queue ? workload.size() : 64;
+		if (config.algorithm == ALGORITHM_SJF)
+			result.totals = simulateMultiCore(workload, state, config.smp, 0, ProcessHeap<CompareByBurst>(CompareByBurst{&workload}, capacity), result.multi_core);
+		else if (config.algorithm == ALGORITHM_PRIORITY)
+			result.totals = simulateMultiCore(workload, state, config.smp, 0, ProcessHeap<CompareByPriority>(CompareByPriority{&workload}, capacity), result.multi_core);
+		else
+			result.totals = simulateMultiCore(workload, state, config.smp, config.algorithm == ALGORITHM_ROUND_ROBIN ? config.quantum : 0, RingBuffer(capacity), result.multi_core);
+		return true;
+	}
+
+	switch (config.algorithm)
+	{
+	case ALGORITHM_FCFS:
+		result.totals = simulateSchedule<ArrivalOrder, NonPreemptive, RunToCompletion>(workload, state);
+		break;
+	case ALGORITHM_SJF:
+		result.totals = simulateSchedule<ShortestBurstFirst, NonPreemptive, RunToCompletion>(workload, state);
+		break;
+	case ALGORITHM_SRTF:
+		result.totals = simulateSchedule<ShortestRemainingFirst, PreemptOnArrival, RunToCompletion>(workload, state);
+		break;
+	case ALGORITHM_PRIORITY:
+		result.totals = simulateSchedule<HighestPriorityFirst, NonPreemptive, RunToCompletion>(workload, state);
+		break;
+	case ALGORITHM_PRIORITY_PREEMPTIVE:
+		result.totals = simulateSchedule<HighestPriorityFirst, PreemptOnArrival, RunToCompletion>(workload, state);
+		break;
+	case ALGORITHM_ROUND_ROBIN:
+		result.totals = simulateSchedule<ArrivalOrder, NonPreemptive>(workload, state, FixedQuantum{config.quantum});
+		break;
+	case ALGORITHM_FAIR:
+		result.totals = simulateFair(workload, state, config.min_granularity, config.target_latency);
+		break;
+	case ALGORITHM_FEEDBACK:
+		result.totals = simulateFeedback(workload, state, config.mlfq_quantums, config.boost_period, result.feedback);
+		break;
+	}
+	return true;
+}
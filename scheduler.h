@@ -0,0 +1,449 @@
+/**========================================================================
+ * @author         :  Muhammad Zaid Bari
+ * @email          :  zaidbari99@gmail.com
+ * @repo           :  https://github.com/zaidbari/cmpe351-project
+ * @createdOn      :  December 06, 2022
+ * @description    :	CPU scheduling simulation library
+ *========================================================================**/
+
+/*
+ * A Workload is only ever read and every run writes into a Result owned by
+ * the caller; the library keeps no global state. Any number of threads may
+ * simulate the same workload at once without locking.
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* ------------------------------ Header files ------------------------------ */
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* -------------------------- Variable definitaions ------------------------- */
+#define PRIORITY_LEVELS 4096 // 64 x 64 buckets, see PriorityBuckets
+#define HISTOGRAM_SUB_BUCKET_BITS 10				 // 1024 linear buckets per power of two: < 0.1% error
+#define MAX_CPUS 1024												 // most cores of a multi-core run
+#define CFS_TARGET_LATENCY_MS 6											 // fair scheduler period while few processes are runnable
+#define DEFAULT_MIN_GRANULARITY_MS 0.75							 // shortest fair scheduler slice
+#define MLFQ_MAX_LEVELS 64													 // feedback queue levels
+
+/*
+ * Metrics: phase timers and scheduler counters, compiled in unless NO_METRICS
+ * is defined. Without them every METRIC_* statement expands to nothing.
+ */
+#ifndef NO_METRICS
+#define METRIC_ADD(counter, amount) ((counter) += (amount))
+#define METRIC_MAX(counter, value) ((counter) = std::max<size_t>((counter), (value)))
+#define METRIC_SET(counter, value) ((counter) = (value))
+#define METRIC_PHASE(timer, seconds) PhaseTimer timer(seconds)
+#else
+#define METRIC_ADD(counter, amount) ((void)0)
+#define METRIC_MAX(counter, value) ((void)0)
+#define METRIC_SET(counter, value) ((void)0)
+#define METRIC_PHASE(timer, seconds) ((void)0)
+#endif
+// All simulation times are integer ticks: exact sums and cheap comparisons on any trace length
+typedef int64_t Tick;
+typedef __int128 TickTotal; // sum of Ticks over a whole workload, can't overflow
+
+/* ------------------------- Structure definiations ------------------------- */
+/**
+ * One column of the process table. It either owns its values (filled by
+ * the text parser) or is a read-only view into a memory-mapped binary
+ * workload, which is used as is without any parsing or copying.
+ */
+template <class T>
+struct Column
+{
+	std::vector<T> storage;
+	const T *values = nullptr;
+	size_t count = 0;
+
+	Column() = default;
+	Column(const Column &) = delete;
+	Column &operator=(const Column &) = delete;
+
+	const T &operator[](size_t i) const { return values[i]; }
+	const T *begin() const { return values; }
+	const T *end() const { return values + count; }
+	size_t size() const { return count; }
+
+	void reserve(size_t n)
+	{
+		storage.reserve(n);
+		values = storage.data();
+	}
+
+	void resize(size_t n)
+	{
+		storage.resize(n);
+		values = storage.data();
+		count = n;
+	}
+
+	void push_back(T value)
+	{
+		storage.push_back(value);
+		values = storage.data();
+		count = storage.size();
+	}
+
+	void view(const T *data, size_t n)
+	{
+		storage.clear();
+		values = data;
+		count = n;
+	}
+
+	void clear() { view(nullptr, 0); }
+};
+
+/**
+ * Workload stored as a structure of arrays: process i lives at index i of
+ * every column, so loading is a plain append and the simulators scan
+ * contiguous memory instead of chasing list pointers.
+ */
+struct Workload
+{
+	Column<int> pid;
+	Column<Tick> arrival_time;
+	Column<Tick> burst_time;
+	Column<int> priority;
+
+	size_t size() const { return pid.size(); }
+
+	void clear()
+	{
+		pid.clear();
+		arrival_time.clear();
+		burst_time.clear();
+		priority.clear();
+	}
+};
+
+/**
+ * Counters and phase times of one simulation run (see METRIC_*)
+ */
+struct SchedulerMetrics
+{
+	double sort_seconds = 0;		 // arrival order sort
+	double simulate_seconds = 0; // whole engine, sort included
+	double report_seconds = 0;	 // formatting the per-process lines
+	double aggregate_seconds = 0; // summary statistics, see aggregateResults
+	long long dispatches = 0;		 // CPU handed to a process, also when it keeps running
+	long long preemptions = 0;	 // CPU taken from an unfinished process
+	long long context_switches = 0;
+	long long queue_operations = 0; // ready queue push, pop and key updates
+	Tick idle_time = 0;							// CPU idle waiting for an arrival
+	Tick makespan = 0;							// time of the last completion
+	size_t peak_ready = 0;					// longest ready queue
+};
+
+/**
+ * Adds the lifetime of a scope to a phase total (monotonic clock)
+ */
+struct PhaseTimer
+{
+	double &seconds;
+	std::chrono::steady_clock::time_point start;
+
+	explicit PhaseTimer(double &total) : seconds(total), start(std::chrono::steady_clock::now()) {}
+	~PhaseTimer() { seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+};
+
+/**
+ * Mutable per-run state, indexed like the Workload. Every simulation owns
+ * its own copy so the workload itself is never modified.
+ */
+struct ProcessState
+{
+	std::vector<Tick> remaining_time;
+	std::vector<Tick> waiting_time;
+	std::vector<Tick> turnaround_time;
+	std::vector<Tick> completion_time;
+	std::vector<Tick> response_time; // -1 until first dispatched
+	std::vector<char> completed;
+	std::vector<int> order; // reusable buffer for sortProcesses
+	SchedulerMetrics metrics;
+};
+
+// Keys the workload can be ordered by (a higher priority value runs first)
+enum SortKey
+{
+	SORT_BY_ARRIVAL,
+	SORT_BY_PRIORITY,
+	SORT_BY_BURST
+};
+
+/**
+ * FIFO of process indexes for round robin. A process is never queued twice,
+ * so a capacity of N processes never has to grow; the streaming mode starts
+ * small and lets it double when full.
+ */
+struct RingBuffer
+{
+	std::vector<int> slots; // power of two sized
+	size_t mask;
+	size_t head;
+	size_t count;
+
+	RingBuffer(size_t capacity) : head(0), count(0)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+		slots.resize(size);
+		mask = size - 1;
+	}
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+
+	void push(int process)
+	{
+		if (count == slots.size())
+			grow();
+		slots[(head + count++) & mask] = process;
+	}
+
+	int pop()
+	{
+		int process = slots[head];
+		head = (head + 1) & mask;
+		count--;
+		return process;
+	}
+
+private:
+	void grow()
+	{
+		std::vector<int> larger(slots.size() * 2);
+		for (size_t i = 0; i < count; i++)
+			larger[i] = slots[(head + i) & mask];
+		slots.swap(larger);
+		mask = slots.size() - 1;
+		head = 0;
+	}
+};
+
+// Totals produced by a single simulation run
+struct SimulationResult
+{
+	TickTotal total_waiting_time;
+	TickTotal total_turnaround_time;
+	TickTotal total_response_time;
+	long long context_switches;
+};
+
+// What one core did during a multi-core run
+struct CoreStats
+{
+	Tick busy_time;
+	long long dispatches;
+	long long completed;
+	long long steals; // processes taken from another core's run queue
+};
+
+// Per-core results of a multi-core run, next to the SimulationResult totals
+struct MultiCoreRun
+{
+	std::vector<CoreStats> cores;
+	long long migrations; // dispatches on a different core than the previous slice
+	Tick makespan;
+};
+
+// Level statistics of a multilevel feedback queue run
+struct FeedbackRun
+{
+	long long demotions;
+	long long boosts;
+	std::vector<long long> completed; // processes that finished on each level
+};
+
+/**
+ * Log-linear latency histogram (HDR style) for percentiles in constant
+ * memory. Values below 2^HISTOGRAM_SUB_BUCKET_BITS ticks are exact; above
+ * that every power of two is split into 2^HISTOGRAM_SUB_BUCKET_BITS
+ * buckets. A bucket remembers its value while only one distinct value
+ * has landed in it, so such percentiles are exact. Otherwise the recorded
+ * minimum or maximum is reported when the bucket holds it, and the
+ * bucket's lower bound when it doesn't, less than 0.1% off. Histograms
+ * filled on different threads are combined with merge.
+ */
+struct LatencyHistogram
+{
+	static constexpr Tick MIXED = INT64_MIN; // bucket holds several distinct values
+
+	std::vector<uint64_t> counts;
+	std::vector<Tick> only; // the one value of a bucket, or MIXED
+	uint64_t count = 0;
+	Tick minimum = INT64_MAX;
+	Tick maximum = INT64_MIN;
+
+	LatencyHistogram()
+			: counts((64 - HISTOGRAM_SUB_BUCKET_BITS) << HISTOGRAM_SUB_BUCKET_BITS, 0), only(counts.size(), 0) {}
+
+	static size_t bucketOf(Tick value)
+	{
+		uint64_t magnitude = value < 0 ? 0 : value;
+		if (magnitude < (1ULL << HISTOGRAM_SUB_BUCKET_BITS))
+			return magnitude;
+		int shift = 63 - __builtin_clzll(magnitude) - HISTOGRAM_SUB_BUCKET_BITS;
+		return ((size_t)(shift + 1) << HISTOGRAM_SUB_BUCKET_BITS) + (magnitude >> shift) - (1ULL << HISTOGRAM_SUB_BUCKET_BITS);
+	}
+
+	// smallest value that falls into bucket
+	static Tick bucketValue(size_t bucket)
+	{
+		if (bucket < (1ULL << HISTOGRAM_SUB_BUCKET_BITS))
+			return bucket;
+		int shift = (bucket >> HISTOGRAM_SUB_BUCKET_BITS) - 1;
+		uint64_t lowest = (bucket & ((1ULL << HISTOGRAM_SUB_BUCKET_BITS) - 1)) + (1ULL << HISTOGRAM_SUB_BUCKET_BITS);
+		return lowest << shift;
+	}
+
+	void record(Tick value)
+	{
+		size_t bucket = bucketOf(value);
+		if (counts[bucket]++ == 0)
+			only[bucket] = value;
+		else if (only[bucket] != value)
+			only[bucket] = MIXED;
+		count++;
+		minimum = std::min(minimum, value);
+		maximum = std::max(maximum, value);
+	}
+
+	void merge(const LatencyHistogram &other)
+	{
+		for (size_t bucket = 0; bucket < counts.size(); bucket++)
+		{
+			if (counts[bucket] == 0)
+				only[bucket] = other.only[bucket];
+			else if (other.counts[bucket] != 0 && only[bucket] != other.only[bucket])
+				only[bucket] = MIXED;
+			counts[bucket] += other.counts[bucket];
+		}
+		count += other.count;
+		minimum = std::min(minimum, other.minimum);
+		maximum = std::max(maximum, other.maximum);
+	}
+
+	// value below which percent % of the recorded values lie
+	Tick percentile(double percent) const
+	{
+		if (count == 0)
+			return 0;
+		uint64_t rank = std::max<uint64_t>(1, std::ceil(percent / 100.0 * count));
+		uint64_t seen = 0;
+		for (size_t bucket = 0; bucket < counts.size(); bucket++)
+			if ((seen += counts[bucket]) >= rank)
+			{
+				if (only[bucket] != MIXED)
+					return only[bucket];
+				if (bucket == bucketOf(maximum))
+					return maximum;
+				if (bucket == bucketOf(minimum))
+					return minimum;
+				return bucketValue(bucket);
+			}
+		return maximum;
+	}
+};
+
+enum SummaryColumn
+{
+	SUMMARY_WAITING,
+	SUMMARY_TURNAROUND,
+	SUMMARY_RESPONSE,
+	SUMMARY_COLUMNS
+};
+
+/**
+ * Summary statistics of a finished run, built in one pass over the result
+ * columns by aggregateResults. Slowdown is turnaround / burst.
+ */
+struct ResultSummary
+{
+	TickTotal total[SUMMARY_COLUMNS];
+	Tick minimum[SUMMARY_COLUMNS];
+	Tick maximum[SUMMARY_COLUMNS];
+	double slowdown_lanes[4]; // process i is added to lane i % 4, the same in every kernel
+	double slowdown_square_lanes[4];
+	double slowdown_total;
+	double slowdown_square_total;
+	double slowdown_max;
+	size_t count;
+	LatencyHistogram latency[SUMMARY_COLUMNS]; // percentiles
+};
+
+struct smp_options
+{
+	unsigned cpus;		 // 0 = the single CPU engines
+	bool global_queue; // one run queue shared by every core instead of one per core
+	bool steal;				 // an idle core takes work from the longest run queue
+};
+
+// Scheduling methods of simulate (a higher priority value runs first)
+enum Algorithm
+{
+	ALGORITHM_FCFS,
+	ALGORITHM_SJF,	// shortest job first, non-preemptive
+	ALGORITHM_SRTF, // shortest remaining time first
+	ALGORITHM_PRIORITY,
+	ALGORITHM_PRIORITY_PREEMPTIVE,
+	ALGORITHM_ROUND_ROBIN,
+	ALGORITHM_FAIR,		 // completely fair scheduler
+	ALGORITHM_FEEDBACK // multilevel feedback queue
+};
+
+/**
+ * What to simulate. Times are ticks of the workload; createSchedulerConfig
+ * fills in the defaults for a time resolution, checkConfig tells whether a
+ * configuration can run on a workload.
+ */
+struct SchedulerConfig
+{
+	Algorithm algorithm;
+	Tick quantum;										 // round robin time quantum
+	Tick min_granularity;						 // shortest fair scheduler slice
+	Tick target_latency;						 // fair scheduler period while few processes are runnable
+	std::vector<Tick> mlfq_quantums; // feedback queue quantum per level, top level first
+	Tick boost_period;							 // time between feedback queue boosts, 0 = never
+	smp_options smp;								 // cpus > 0 runs fcfs, sjf, prio or rr on that many cores
+};
+
+/**
+ * Everything one run writes, owned by the caller. simulate resizes the
+ * per-process buffers to the workload without giving their memory back,
+ * so a Result reused for runs of the same size does not grow again.
+ */
+struct Result
+{
+	ProcessState state; // per-process times, indexed like the workload
+	SimulationResult totals;
+	MultiCoreRun multi_core; // when config.smp.cpus > 0
+	FeedbackRun feedback;		 // for ALGORITHM_FEEDBACK
+};
+
+/* ------------------------- function defininations ------------------------- */
+SchedulerConfig createSchedulerConfig(Algorithm algorithm, Tick ticks_per_ms);
+std::string checkConfig(const Workload &workload, const SchedulerConfig &config);
+bool simulate(const Workload &workload, const SchedulerConfig &config, Result &result);
+
+void sortProcesses(const Workload &table, SortKey key, std::vector<int> &order);
+ResultSummary createResultSummary();
+void addResult(ResultSummary &summary, size_t row, Tick waiting_time, Tick turnaround_time, Tick response_time, Tick burst_time);
+void finishSummary(ResultSummary &summary);
+ResultSummary aggregateResults(const ProcessState &state, const Workload &table);
+void runParallel(size_t task_count, unsigned thread_count, const std::function<void(size_t)> &task);
+#ifdef BENCHMARK
+std::string checkAggregateKernels(const ProcessState &state, const Workload &table);
+#endif
+
+#endif